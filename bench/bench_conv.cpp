@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <unsupported/Eigen/CXX11/ThreadPool>
+
+#include "layer/conv_2d.h"
+
+// 3x3 stride 1 depthwise conv of 56x56x128 on one thread, the direct kernel
+// against the per channel im2col it replaced
+static void BM_Conv2d_Depthwise_56x56x128(benchmark::State &state) {
+    using namespace SimpleInfer;
+
+    const int image_size = 56;
+    const int channel    = 128;
+    const int kernel     = 3;
+
+    Tensor input(DataType::kFloat32,
+                 {1, image_size, image_size, channel},
+                 true);
+    Tensor output(DataType::kFloat32,
+                  {1, image_size, image_size, channel},
+                  true);
+    input.GetEigenTensor<float, 4>().setRandom();
+
+    Conv2d conv_2d_layer;
+    conv_2d_layer.use_bias_     = true;
+    conv_2d_layer.in_channels_  = channel;
+    conv_2d_layer.out_channels_ = channel;
+    conv_2d_layer.groups_       = channel;
+    conv_2d_layer.kernel_h_     = kernel;
+    conv_2d_layer.kernel_w_     = kernel;
+    conv_2d_layer.stride_h_     = 1;
+    conv_2d_layer.stride_w_     = 1;
+    conv_2d_layer.dilation_h_   = 1;
+    conv_2d_layer.dilation_w_   = 1;
+    conv_2d_layer.padding_mode_ = Conv2d::PaddingMode::kZeros;
+    conv_2d_layer.padding_t_    = kernel / 2;
+    conv_2d_layer.padding_b_    = kernel / 2;
+    conv_2d_layer.padding_l_    = kernel / 2;
+    conv_2d_layer.padding_r_    = kernel / 2;
+
+    // HWIO with one input channel per group
+    EigenDSize<4> weight_shape(kernel, kernel, 1, channel);
+    conv_2d_layer.weight_shape_ = weight_shape;
+    conv_2d_layer.weight_.resize(weight_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 4>(
+        reinterpret_cast<float *>(conv_2d_layer.weight_.data()),
+        weight_shape)
+        .setRandom();
+
+    EigenDSize<1> bias_shape(channel);
+    conv_2d_layer.bias_shape_ = bias_shape;
+    conv_2d_layer.bias_.resize(bias_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 1>(
+        reinterpret_cast<float *>(conv_2d_layer.bias_.data()),
+        bias_shape)
+        .setRandom();
+
+    conv_2d_layer.InitDepthwise();
+    conv_2d_layer.use_depthwise_ = (0 != state.range(0));
+    state.SetLabel(conv_2d_layer.use_depthwise_ ? "depthwise" : "im2col");
+
+    Eigen::ThreadPool thread_pool(1);
+    Eigen::ThreadPoolDevice device(&thread_pool, 1);
+    conv_2d_layer.SetEigenThreadPoolDevice(&device);
+
+    conv_2d_layer.Forward(input, output);
+
+    for (auto _ : state) {
+        conv_2d_layer.Forward(input, output);
+    }
+}
+
+BENCHMARK(BM_Conv2d_Depthwise_56x56x128)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
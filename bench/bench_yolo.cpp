@@ -4,7 +4,9 @@
 
 #include "engine.h"
 
-static void BM_Yolov5s_Batch8_640x640(benchmark::State &state) {
+// load yolov5s once, warm up, then time Forward
+static void RunYolov5sBatch8(benchmark::State &state,
+                             const SimpleInfer::EngineOptions &options) {
     using namespace SimpleInfer;
 
     const std::string model_path(MODEL_PATH);
@@ -16,7 +18,7 @@ static void BM_Yolov5s_Batch8_640x640(benchmark::State &state) {
     InitializeContext();
 
     Engine engine;
-    engine.LoadModel(param_file, bin_file);
+    engine.LoadModel(param_file, bin_file, options);
 
     Tensor input(SimpleInfer::DataType::kFloat32, {8, 640, 640, 3}, true);
     engine.Input("0", input);
@@ -31,4 +33,31 @@ static void BM_Yolov5s_Batch8_640x640(benchmark::State &state) {
     engine.Extract("140", output);
 }
 
+static void BM_Yolov5s_Batch8_640x640(benchmark::State &state) {
+    RunYolov5sBatch8(state, SimpleInfer::EngineOptions());
+}
+
 BENCHMARK(BM_Yolov5s_Batch8_640x640)->Unit(benchmark::kMillisecond);
+
+// same model on each executor, the difference is scheduling overhead
+static void BM_Yolov5s_Batch8_640x640_Pipeline(benchmark::State &state) {
+    using namespace SimpleInfer;
+
+    static const char *labels[] = {"cgraph static",
+                                   "cgraph dynamic",
+                                   "sequential",
+                                   "cost model"};
+    state.SetLabel(labels[state.range(0)]);
+
+    EngineOptions options;
+    options.pipeline_type = static_cast<PipelineType>(state.range(0));
+
+    RunYolov5sBatch8(state, options);
+}
+
+BENCHMARK(BM_Yolov5s_Batch8_640x640_Pipeline)
+    ->Arg((int)SimpleInfer::PipelineType::kStatic)
+    ->Arg((int)SimpleInfer::PipelineType::kDynamic)
+    ->Arg((int)SimpleInfer::PipelineType::kSequential)
+    ->Arg((int)SimpleInfer::PipelineType::kCostModel)
+    ->Unit(benchmark::kMillisecond);
@@ -3,6 +3,7 @@
 
 #include <string>
 
+#include "options.h"
 #include "tensor.h"
 #include "types.h"
 
@@ -18,6 +19,10 @@ public:
 public:
     Status LoadModel(const std::string& parampath, const std::string& binpath);
 
+    Status LoadModel(const std::string& parampath,
+                     const std::string& binpath,
+                     const EngineOptions& options);
+
     Status Release();
 
 public:
@@ -29,8 +34,27 @@ public:
 
     Status Forward();
 
+    // run only the layers the given outputs depend on, one after another on
+    // the calling thread whatever the pipeline_type, layers still use their
+    // intra-op threads. Outputs not requested are undefined, their memory may
+    // be reused by the layers run. The plan is cached per output set
+    Status Forward(const std::vector<std::string>& output_names);
+
+    // zero copy, output shares engine memory and stays valid after the next
+    // Forward, which then runs on fresh memory for that output only
     Status Extract(const std::string& name, Tensor& output);
 
+public:
+    // profiling, needs EngineOptions::enable_profile
+
+    // chrome trace_event json of all recorded layers
+    Status SaveProfile(const std::string& path);
+
+    // per layer statistics, slowest first
+    const std::string ProfileSummary();
+
+    Status ClearProfile();
+
 private:
     EngineImpl* impl_ = nullptr;
 };
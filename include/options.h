@@ -0,0 +1,65 @@
+#ifndef SIMPLE_INFER_INCLUDE_OPTIONS_H_
+#define SIMPLE_INFER_INCLUDE_OPTIONS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace SimpleInfer {
+
+// how layers are scheduled
+enum class PipelineType {
+    kStatic = 0,  // CGraph, fixed plan from graph structure
+    kDynamic,     // CGraph, nodes are dispatched as they become ready
+    kSequential,  // one topological order on the calling thread, parallelism
+                  // inside layers only
+    kCostModel    // critical path first, threads split between concurrent
+                  // branches and inside layers from estimated layer cost
+};
+
+// kernel preferences of a layer, a layer falls back when unsupported
+struct KernelOptions {
+    bool use_winograd = true;
+};
+
+struct EngineOptions {
+    // intra-op threads of a layer, 0 for the number of cpus used
+    int num_threads = 0;
+
+    // pin intra-op thread i to cpu_ids[i % size], empty for no pinning
+    std::vector<int> cpu_ids;
+
+    // use the cpus of a numa node when cpu_ids is empty, -1 for any node.
+    // Tensor memory is first touched by the pinned threads, so one engine per
+    // node keeps activations local.
+    int numa_node = -1;
+
+    // inter-op threads running layers concurrently, 0 for the max parallelism
+    // of the graph
+    int num_pipeline_threads = 0;
+
+    PipelineType pipeline_type = PipelineType::kStatic;
+
+    // fold and fuse layers at load time, off so a model runs the graph it was
+    // exported with unless asked
+    bool optimize_graph = false;
+
+    // internal layout of rank 4 activations, graph inputs and outputs stay
+    // NHWC. Layers without support for a blocked layout run in NHWC and
+    // Reorder layers are inserted where the two meet, see LayoutPlanner
+    Layout layout = Layout::kNHWC;
+
+    // record per layer events, see Engine::SaveProfile
+    bool enable_profile = false;
+
+    KernelOptions kernel_options;
+
+    // override kernel_options, keyed by layer name or op type, e.g. nn.Conv2d
+    std::map<std::string, KernelOptions> layer_kernel_options;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_INCLUDE_OPTIONS_H_
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cassert>
+#include <memory>
 #include <vector>
 
 #include "eigen_helper.h"
@@ -10,6 +11,8 @@
 
 namespace SimpleInfer {
 
+// Tensor data lives in a ref-counted storage block shared by all copies, or in
+// external memory which is not owned. Copies are cheap views.
 class Tensor {
 public:
     Tensor();
@@ -24,6 +27,10 @@ public:
 
     Tensor& operator=(const Tensor& tensor);
 
+    Tensor(Tensor&& tensor) noexcept;
+
+    Tensor& operator=(Tensor&& tensor) noexcept;
+
 public:
     Status Allocate();
 
@@ -31,20 +38,53 @@ public:
 
     Status Deallocate();
 
+    // use external memory, which is not owned by tensor
+    Status SetData(void* data);
+
+    // share a storage block, data starts at byte offset
+    Status SetData(const std::shared_ptr<void>& storage, size_t offset = 0);
+
+    // same memory with a new shape, total size must not change
+    Status Reshape(const std::vector<int>& shape);
+
+    // number of tensors sharing the storage, 0 for external memory
+    long UseCount() const;
+
+    // first element, rows of the last dimension are RowStride() apart
+    void* Data() const;
+
+    // contiguous copy into dst, reusing its storage when dst is the only
+    // user and the shape matches
+    Status CopyTo(Tensor& dst) const;
+
     const DataType GetDataType() const;
 
     const std::vector<int>& Shape() const;
 
+    // elements between two adjacent rows of the last dimension, larger than
+    // the last dimension when tensor is a channel view of a concatenated one
+    int RowStride() const;
+
+    Status SetRowStride(const int row_stride);
+
+    bool IsContiguous() const;
+
+    // memory order of a rank 4 tensor, Shape() is the stored shape
+    Layout GetLayout() const;
+
+    void SetLayout(const Layout layout);
+
 public:
     template<typename T, int num_indices>
     Status SetEigenTensor(const EigenTensorMap<T, num_indices>& tensor_map) {
-        if (use_internal_data_) {
-            return Status::kFail;
-        }
-
         assert(IsSameDataType<T>(data_type_));
         assert(num_indices >= 0);
 
+        // owned or shared storage is never dropped behind other users
+        if (nullptr != storage_) {
+            return Status::kFail;
+        }
+
         data_ = tensor_map.data();
 
         return Status::kSuccess;
@@ -53,19 +93,37 @@ public:
     template<typename T, int num_indices, int Options = 0x1>
     EigenTensorMap<T, num_indices> GetEigenTensor() const {
         assert(IsSameDataType<T>(data_type_));
+        assert(IsContiguous());
 
         return EigenTensorMap<T, num_indices, Options>(
             static_cast<T*>(data_),
             ToEigenDSize<num_indices>(shape_));
     }
 
+    // last dimension padded to RowStride(), slice it with Shape() before use
+    template<typename T, int num_indices, int Options = 0x1>
+    EigenTensorMap<T, num_indices> GetEigenPaddedTensor() const {
+        assert(IsSameDataType<T>(data_type_));
+
+        EigenDSize<num_indices> dsize = ToEigenDSize<num_indices>(shape_);
+        dsize[num_indices - 1]        = RowStride();
+
+        return EigenTensorMap<T, num_indices, Options>(static_cast<T*>(data_),
+                                                       dsize);
+    }
+
 protected:
     DataType data_type_ = DataType::kNone;
 
     std::vector<int> shape_;
 
-    bool use_internal_data_ = false;
-    void* data_             = nullptr;
+    // 0 for contiguous memory
+    int row_stride_ = 0;
+
+    Layout layout_ = Layout::kNHWC;
+
+    std::shared_ptr<void> storage_;
+    void* data_ = nullptr;
 };
 
 }  // namespace SimpleInfer
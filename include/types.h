@@ -21,6 +21,11 @@ enum class DataType {
     kComplex32
 };
 
+// memory order of rank 4 activations. A blocked layout NCHWc keeps channel
+// blocks of c = 4 or 8 innermost and is stored as an NHWC tensor of shape
+// [n * ceil(channel / c), h, w, c], padded channels hold unspecified values.
+enum class Layout { kNHWC = 0, kNC4HW4, kNC8HW8 };
+
 enum class Status {
     kSuccess = 0,
     kFail,
@@ -56,6 +61,13 @@ int ElementSize(const DataType data_type);
 bool IsSameShape(const std::vector<int>& shape0,
                  const std::vector<int>& shape1);
 
+// channels of a block, 0 for NHWC
+int LayoutBlock(const Layout layout);
+
+// stored shape of an NHWC shape, only rank 4 shapes are blocked
+std::vector<int> LayoutShape(const std::vector<int>& shape,
+                             const Layout layout);
+
 }  // namespace SimpleInfer
 
 #endif  // SIMPLE_INFER_INCLUDE_TYPES_H_
@@ -3,6 +3,7 @@
 #include <pybind11/stl.h>
 
 #include "engine.h"
+#include "options.h"
 #include "tensor.h"
 #include "types.h"
 
@@ -27,6 +28,36 @@ PYBIND11_MODULE(simpleinfer, m) {
         .value("ErrorContext", Status::kErrorContext)
         .value("Unsupport", Status::kUnsupport);
 
+    py::enum_<PipelineType>(m, "PipelineType")
+        .value("Static", PipelineType::kStatic)
+        .value("Dynamic", PipelineType::kDynamic)
+        .value("Sequential", PipelineType::kSequential)
+        .value("CostModel", PipelineType::kCostModel);
+
+    py::enum_<Layout>(m, "Layout")
+        .value("NHWC", Layout::kNHWC)
+        .value("NC4HW4", Layout::kNC4HW4)
+        .value("NC8HW8", Layout::kNC8HW8);
+
+    py::class_<KernelOptions>(m, "KernelOptions")
+        .def(py::init<>())
+        .def_readwrite("use_winograd", &KernelOptions::use_winograd);
+
+    py::class_<EngineOptions>(m, "EngineOptions")
+        .def(py::init<>())
+        .def_readwrite("num_threads", &EngineOptions::num_threads)
+        .def_readwrite("cpu_ids", &EngineOptions::cpu_ids)
+        .def_readwrite("numa_node", &EngineOptions::numa_node)
+        .def_readwrite("num_pipeline_threads",
+                       &EngineOptions::num_pipeline_threads)
+        .def_readwrite("pipeline_type", &EngineOptions::pipeline_type)
+        .def_readwrite("optimize_graph", &EngineOptions::optimize_graph)
+        .def_readwrite("layout", &EngineOptions::layout)
+        .def_readwrite("enable_profile", &EngineOptions::enable_profile)
+        .def_readwrite("kernel_options", &EngineOptions::kernel_options)
+        .def_readwrite("layer_kernel_options",
+                       &EngineOptions::layer_kernel_options);
+
     py::class_<Tensor>(m, "Tensor")
         .def(py::init<>())
         .def(py::init<DataType, std::vector<int>>())
@@ -51,6 +82,11 @@ PYBIND11_MODULE(simpleinfer, m) {
              static_cast<Status (Engine::*)(const std::string&,
                                             const std::string&)>(
                  &Engine::LoadModel))
+        .def("LoadModel",
+             static_cast<Status (Engine::*)(const std::string&,
+                                            const std::string&,
+                                            const EngineOptions&)>(
+                 &Engine::LoadModel))
         .def("Release", static_cast<Status (Engine::*)()>(&Engine::Release))
         .def("InputNames",
              static_cast<const std::vector<std::string> (Engine::*)()>(
@@ -62,7 +98,18 @@ PYBIND11_MODULE(simpleinfer, m) {
              static_cast<Status (Engine::*)(const std::string&, const Tensor&)>(
                  &Engine::Input))
         .def("Forward", static_cast<Status (Engine::*)()>(&Engine::Forward))
+        .def("Forward",
+             static_cast<Status (Engine::*)(const std::vector<std::string>&)>(
+                 &Engine::Forward))
         .def("Extract",
              static_cast<Status (Engine::*)(const std::string&, Tensor&)>(
-                 &Engine::Extract));
+                 &Engine::Extract))
+        .def("SaveProfile",
+             static_cast<Status (Engine::*)(const std::string&)>(
+                 &Engine::SaveProfile))
+        .def("ProfileSummary",
+             static_cast<const std::string (Engine::*)()>(
+                 &Engine::ProfileSummary))
+        .def("ClearProfile",
+             static_cast<Status (Engine::*)()>(&Engine::ClearProfile));
 }
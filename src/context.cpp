@@ -6,8 +6,13 @@ Context::Context() {}
 
 Context::~Context() {}
 
-void Context::InitEigenThreadPoolDevice(int num_threads) {
-    eigen_threadpool_.reset(new Eigen::ThreadPool(num_threads));
+void Context::InitEigenThreadPoolDevice(int num_threads,
+                                        const std::vector<int>& cpu_ids) {
+    cpu_ids_ = cpu_ids;
+    eigen_threadpool_.reset(
+        new AffinityThreadPool(num_threads,
+                               true,
+                               AffinityThreadEnvironment(cpu_ids)));
     eigen_threadpool_device_.reset(
         new Eigen::ThreadPoolDevice(eigen_threadpool_.get(), num_threads));
 }
@@ -16,6 +21,10 @@ Eigen::ThreadPoolDevice* Context::GetEigenThreadPoolDevice() {
     return eigen_threadpool_device_.get();
 }
 
+Eigen::ThreadPoolInterface* Context::GetThreadPool() {
+    return eigen_threadpool_.get();
+}
+
 Eigen::ThreadPoolDevice* Context::GetDefaultEigenThreadPoolDevice() {
     static Eigen::ThreadPool default_eigen_threadpool(1);
     static Eigen::ThreadPoolDevice default_eigen_threadpool_device(
@@ -25,4 +34,33 @@ Eigen::ThreadPoolDevice* Context::GetDefaultEigenThreadPoolDevice() {
     return &default_eigen_threadpool_device;
 }
 
+const std::vector<int>& Context::GetCpuIds() const {
+    return cpu_ids_;
+}
+
+void Context::SetOptions(const EngineOptions& options) {
+    options_ = options;
+}
+
+const EngineOptions& Context::GetOptions() const {
+    return options_;
+}
+
+const KernelOptions& Context::GetKernelOptions(const std::string& name,
+                                               const std::string& type) const {
+    const auto& layer_kernel_options = options_.layer_kernel_options;
+
+    auto name_iter = layer_kernel_options.find(name);
+    if (layer_kernel_options.end() != name_iter) {
+        return name_iter->second;
+    }
+
+    auto type_iter = layer_kernel_options.find(type);
+    if (layer_kernel_options.end() != type_iter) {
+        return type_iter->second;
+    }
+
+    return options_.kernel_options;
+}
+
 }  // namespace SimpleInfer
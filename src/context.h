@@ -2,10 +2,15 @@
 #define SIMPLE_INFER_SRC_CONTEXT_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <unsupported/Eigen/CXX11/Tensor>
 #include <unsupported/Eigen/CXX11/ThreadPool>
 
+#include "cpu_affinity.h"
+#include "options.h"
+
 namespace SimpleInfer {
 
 class Context {
@@ -15,15 +20,36 @@ public:
     virtual ~Context();
 
 public:
-    // Eigen ThreadPool Device
-    void InitEigenThreadPoolDevice(int num_threads = 8);
+    // Eigen ThreadPool Device, its persistent work-stealing pool is shared
+    // by all parallel kernels, see Parallel(). Threads are pinned to cpu_ids
+    // when given.
+    void InitEigenThreadPoolDevice(int num_threads = 8,
+                                   const std::vector<int>& cpu_ids = {});
 
     Eigen::ThreadPoolDevice* GetEigenThreadPoolDevice();
 
+    Eigen::ThreadPoolInterface* GetThreadPool();
+
     static Eigen::ThreadPoolDevice* GetDefaultEigenThreadPoolDevice();
 
+    // cpus the pool threads are pinned to, empty when not pinned
+    const std::vector<int>& GetCpuIds() const;
+
+    // Options
+    void SetOptions(const EngineOptions& options);
+
+    const EngineOptions& GetOptions() const;
+
+    // by layer name first, then op type, then engine default
+    const KernelOptions& GetKernelOptions(const std::string& name,
+                                          const std::string& type) const;
+
 protected:
-    std::unique_ptr<Eigen::ThreadPool> eigen_threadpool_;
+    EngineOptions options_;
+
+    std::vector<int> cpu_ids_;
+
+    std::unique_ptr<AffinityThreadPool> eigen_threadpool_;
     std::unique_ptr<Eigen::ThreadPoolDevice> eigen_threadpool_device_;
 };
 
@@ -0,0 +1,134 @@
+#include "cpu_affinity.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "logger.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace SimpleInfer {
+
+Status SetThreadAffinity(int cpu_id) {
+    if (cpu_id < 0) {
+        return Status::kFail;
+    }
+
+#if defined(_WIN32)
+    if (cpu_id >= (int)(sizeof(DWORD_PTR) * 8)) {
+        LOG(ERROR) << "SetThreadAffinity fail [cpu " << cpu_id
+                   << " out of group]";
+        return Status::kUnsupport;
+    }
+
+    const DWORD_PTR mask = (DWORD_PTR)1 << cpu_id;
+    if (0 == SetThreadAffinityMask(GetCurrentThread(), mask)) {
+        LOG(ERROR) << "SetThreadAffinity fail [cpu " << cpu_id << "]";
+        return Status::kFail;
+    }
+
+    return Status::kSuccess;
+#elif defined(__linux__)
+    if (cpu_id >= CPU_SETSIZE) {
+        LOG(ERROR) << "SetThreadAffinity fail [cpu " << cpu_id
+                   << " out of range]";
+        return Status::kFail;
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu_id, &cpu_set);
+
+    if (0 != sched_setaffinity(0, sizeof(cpu_set), &cpu_set)) {
+        LOG(ERROR) << "SetThreadAffinity fail [cpu " << cpu_id << "]";
+        return Status::kFail;
+    }
+
+    return Status::kSuccess;
+#else
+    LOG(WARNING) << "SetThreadAffinity unsupported on this platform";
+    return Status::kUnsupport;
+#endif
+}
+
+Status ParseCpuList(const std::string& cpu_list, std::vector<int>& cpu_ids) {
+    cpu_ids.clear();
+
+    std::stringstream ss(cpu_list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+
+        // first[-last]
+        const char* begin = range.c_str();
+        char* end         = nullptr;
+
+        const long first = std::strtol(begin, &end, 10);
+        long last        = first;
+        bool valid       = (begin != end);
+
+        if (valid && '-' == *end) {
+            begin = end + 1;
+            last  = std::strtol(begin, &end, 10);
+            valid = (begin != end);
+        }
+
+        while (valid && std::isspace((unsigned char)*end)) {
+            ++end;
+        }
+
+        if (!valid || '\0' != *end || first < 0 || last < first) {
+            LOG(ERROR) << "ParseCpuList fail [bad range " << range << "]";
+            cpu_ids.clear();
+            return Status::kFail;
+        }
+
+        for (long cpu_id = first; cpu_id <= last; ++cpu_id) {
+            cpu_ids.push_back((int)cpu_id);
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+Status GetNumaNodeCpus(int numa_node, std::vector<int>& cpu_ids) {
+    cpu_ids.clear();
+
+#if defined(__linux__)
+    const std::string path = "/sys/devices/system/node/node" +
+                             std::to_string(numa_node) + "/cpulist";
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG(ERROR) << "GetNumaNodeCpus fail [can not open " << path << "]";
+        return Status::kFail;
+    }
+
+    std::string cpu_list;
+    std::getline(file, cpu_list);
+
+    CHECK_STATUS(ParseCpuList(cpu_list, cpu_ids));
+
+    if (cpu_ids.empty()) {
+        LOG(ERROR) << "GetNumaNodeCpus fail [node " << numa_node
+                   << " has no cpu]";
+        return Status::kEmpty;
+    }
+
+    return Status::kSuccess;
+#else
+    LOG(ERROR) << "GetNumaNodeCpus unsupported on this platform";
+    return Status::kUnsupport;
+#endif
+}
+
+}  // namespace SimpleInfer
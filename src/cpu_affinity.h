@@ -0,0 +1,54 @@
+#ifndef SIMPLE_INFER_SRC_CPU_AFFINITY_H_
+#define SIMPLE_INFER_SRC_CPU_AFFINITY_H_
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <unsupported/Eigen/CXX11/ThreadPool>
+
+#include "types.h"
+
+namespace SimpleInfer {
+
+// pin calling thread to a cpu
+Status SetThreadAffinity(int cpu_id);
+
+// parse a sysfs cpu list, e.g. 0-15,32-47
+Status ParseCpuList(const std::string& cpu_list, std::vector<int>& cpu_ids);
+
+// cpus of a numa node, from sysfs on linux
+Status GetNumaNodeCpus(int numa_node, std::vector<int>& cpu_ids);
+
+// Eigen thread environment pinning thread i to cpu_ids[i % size]
+struct AffinityThreadEnvironment : public Eigen::StlThreadEnvironment {
+    AffinityThreadEnvironment() {}
+
+    explicit AffinityThreadEnvironment(const std::vector<int>& cpu_ids)
+        : cpu_ids_(cpu_ids) {}
+
+    EnvThread* CreateThread(std::function<void()> f) {
+        if (cpu_ids_.empty()) {
+            return new EnvThread(std::move(f));
+        }
+
+        const int cpu_id = cpu_ids_[num_threads_ % cpu_ids_.size()];
+        ++num_threads_;
+
+        return new EnvThread([cpu_id, f = std::move(f)]() {
+            SetThreadAffinity(cpu_id);
+            f();
+        });
+    }
+
+    std::vector<int> cpu_ids_;
+    size_t num_threads_ = 0;
+};
+
+using AffinityThreadPool = Eigen::ThreadPoolTempl<AffinityThreadEnvironment>;
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_CPU_AFFINITY_H_
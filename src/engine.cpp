@@ -16,7 +16,13 @@ Engine::~Engine() {
 
 Status Engine::LoadModel(const std::string& parampath,
                          const std::string& binpath) {
-    return impl_->LoadModel(parampath, binpath);
+    return impl_->LoadModel(parampath, binpath, EngineOptions());
+}
+
+Status Engine::LoadModel(const std::string& parampath,
+                         const std::string& binpath,
+                         const EngineOptions& options) {
+    return impl_->LoadModel(parampath, binpath, options);
 }
 
 Status Engine::Release() {
@@ -39,10 +45,26 @@ Status Engine::Forward() {
     return impl_->Forward();
 }
 
+Status Engine::Forward(const std::vector<std::string>& output_names) {
+    return impl_->Forward(output_names);
+}
+
 Status Engine::Extract(const std::string& name, Tensor& output) {
     return impl_->Extract(name, output);
 }
 
+Status Engine::SaveProfile(const std::string& path) {
+    return impl_->SaveProfile(path);
+}
+
+const std::string Engine::ProfileSummary() {
+    return impl_->ProfileSummary();
+}
+
+Status Engine::ClearProfile() {
+    return impl_->ClearProfile();
+}
+
 void InitializeContext() {
     InitializeLogger();
 }
@@ -1,12 +1,37 @@
 #include "engine_impl.h"
 
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <thread>
+
+#include "graph_optimizer.h"
 #include "layer.h"
+#include "layer/cat.h"
+#include "layer/expression.h"
 #include "layer_registry.h"
+#include "layout_planner.h"
 #include "logger.h"
+#include "memory_planner.h"
 #include "pnnx/expand_expression.h"
 
 namespace SimpleInfer {
 
+// only rank 4 float activations have a layout
+static bool HasLayout(const Tensor& tensor) {
+    return (4 == tensor.Shape().size() &&
+            IsSameDataType<float>(tensor.GetDataType()));
+}
+
+static size_t TensorSize(const Tensor& tensor) {
+    size_t size = ElementSize(tensor.GetDataType());
+    for (const auto s : tensor.Shape()) {
+        size *= (size_t)s;
+    }
+
+    return size;
+}
+
 EngineImpl::EngineImpl() {}
 
 EngineImpl::~EngineImpl() {
@@ -14,7 +39,8 @@ EngineImpl::~EngineImpl() {
 }
 
 Status EngineImpl::LoadModel(const std::string& parampath,
-                             const std::string& binpath) {
+                             const std::string& binpath,
+                             const EngineOptions& options) {
     {
         Status ret = Release();
         if (Status::kSuccess != ret) {
@@ -23,6 +49,8 @@ Status EngineImpl::LoadModel(const std::string& parampath,
         }
     }
 
+    options_ = options;
+
     {
         Status ret = CreateContext();
         if (Status::kSuccess != ret) {
@@ -129,8 +157,33 @@ Status EngineImpl::Release() {
 Status EngineImpl::CreateContext() {
     context_ = new Context;
 
-    // TODO: set from user
-    context_->InitEigenThreadPoolDevice(16);
+    context_->SetOptions(options_);
+
+    std::vector<int> cpu_ids = options_.cpu_ids;
+    if (cpu_ids.empty() && options_.numa_node >= 0) {
+        Status ret = GetNumaNodeCpus(options_.numa_node, cpu_ids);
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "get cpus of numa node [" << options_.numa_node
+                       << "] fail";
+            return ret;
+        }
+    }
+
+    int num_threads = options_.num_threads;
+    if (num_threads <= 0) {
+        num_threads = cpu_ids.empty()
+                          ? (int)std::thread::hardware_concurrency()
+                          : (int)cpu_ids.size();
+        num_threads = (std::max)(num_threads, 1);
+    }
+
+    LOG(INFO) << "intra-op threads [" << num_threads << "], pinned cpus ["
+              << cpu_ids.size() << "]";
+
+    context_->InitEigenThreadPoolDevice(num_threads, cpu_ids);
+
+    // first touch tensor memory on pinned threads
+    first_touch_ = !cpu_ids.empty();
 
     return Status::kSuccess;
 }
@@ -153,7 +206,20 @@ Status EngineImpl::CreateGraph(const std::string& parampath,
         return Status::kFail;
     }
 
-    pnnx::expand_expression(*graph_);
+    // elementwise chains run fused in one Expression layer
+    if (options_.optimize_graph) {
+        pnnx::expand_expression(*graph_, Expression::IsFusible);
+    } else {
+        pnnx::expand_expression(*graph_);
+    }
+
+    if (options_.optimize_graph) {
+        Status ret = OptimizeGraph(graph_);
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "optimize graph fail";
+            return ret;
+        }
+    }
 
     return Status::kSuccess;
 }
@@ -180,23 +246,28 @@ Status EngineImpl::CreateTensorNodes() {
         tensor_node->operand    = opd;
 
         // NCHW -> NHWC
-        std::vector<int> shape_nhwc = opd->shape;
-        if (shape_nhwc.size() > 3) {
-            int shape_dims             = (int)shape_nhwc.size();
-            shape_nhwc[shape_dims - 1] = opd->shape[shape_dims - 3];
-            shape_nhwc[shape_dims - 2] = opd->shape[shape_dims - 1];
-            shape_nhwc[shape_dims - 3] = opd->shape[shape_dims - 2];
-        }
-
-        tensor_node->tensor =
-            Tensor(PnnxToDataType(opd->type), shape_nhwc, false);
+        tensor_node->tensor = Tensor(PnnxToDataType(opd->type),
+                                     PnnxToNHWCShape(opd->shape),
+                                     false);
 
         tensor_nodes_[opd->name] = tensor_node;
 
         if (nullptr != opd->producer) {
-            // type == "pnnx.Input"
-            if (0 == opd->producer->inputs.size()) {
+            if ("pnnx.Input" == opd->producer->type) {
                 input_tensor_nodes_[opd->name] = tensor_node;
+            } else if ("pnnx.Attribute" == opd->producer->type) {
+                // constant left by FoldConstants or in the model, one that
+                // cannot be loaded is kept without data for its consumers
+                // to reject
+                const pnnx::Attribute* attr = GetConstantAttr(opd->producer);
+                if (nullptr == attr ||
+                    Status::kSuccess !=
+                        AttributeToTensor(*attr, tensor_node->tensor)) {
+                    LOG(WARNING) << "constant [" << opd->name
+                                 << "] kept unloaded";
+                }
+
+                constant_tensor_nodes_[opd->name] = tensor_node;
             }
         }
 
@@ -217,6 +288,7 @@ Status EngineImpl::CreateTensorNodes() {
 Status EngineImpl::DestroyTensorNodes() {
     input_tensor_nodes_.clear();
     output_tensor_nodes_.clear();
+    constant_tensor_nodes_.clear();
 
     for (auto& tensor_node_iter : tensor_nodes_) {
         TensorNode* tensor_node = tensor_node_iter.second;
@@ -226,6 +298,8 @@ Status EngineImpl::DestroyTensorNodes() {
         }
     }
 
+    tensor_nodes_.clear();
+
     return Status::kSuccess;
 }
 
@@ -233,37 +307,26 @@ Status EngineImpl::CreateLayers() {
     for (size_t i = 0; i < graph_->ops.size(); ++i) {
         pnnx::Operator* op = graph_->ops[i];
 
-        if ("pnnx.Input" == op->type || "pnnx.Output" == op->type) {
+        if ("pnnx.Input" == op->type || "pnnx.Output" == op->type ||
+            "pnnx.Attribute" == op->type) {
             continue;
         }
 
-        if (layers_.count(op->name) > 0) {
-            LOG(ERROR) << "layer [" << op->name << "] already exists";
-            return Status::kFail;
-        }
-
-        const LayerRegistryEntry* layer_registry_entry =
-            GetLayerRegistry(op->type);
-        if (nullptr == layer_registry_entry) {
-            LOG(ERROR) << "layer type [" << op->type << "] not registered";
-            return Status::kEmpty;
-        }
+        CHECK_STATUS(CreateLayer(op));
+    }
 
-        Layer* layer = layer_registry_entry->creator();
-        if (nullptr == layer) {
-            LOG(ERROR) << "create layer [" << op->type << "] fail";
-            return Status::kFail;
+    {
+        Status ret = CreateTensorLayouts();
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "CreateTensorLayouts fail";
+            return ret;
         }
+    }
 
-        {
-            Status ret = layer->Init(op);
-            if (Status::kSuccess != ret) {
-                LOG(ERROR) << "layer [" << op->name << "] init fail";
-                return ret;
-            }
-
-            layer->SetContext(context_);
-        }
+    // reorders replace operands of consumers, connect nodes afterwards
+    for (auto& layer_iter : layers_) {
+        Layer* layer             = layer_iter.second;
+        const pnnx::Operator* op = layer->GetOp();
 
         {
             std::vector<SimpleInfer::TensorNode*> input_tensor_nodes;
@@ -302,8 +365,47 @@ Status EngineImpl::CreateLayers() {
                 return ret;
             }
         }
+    }
+
+    {
+        Status ret = CreateTensorAliases();
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "CreateTensorAliases fail";
+            return ret;
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+Status EngineImpl::CreateLayer(const pnnx::Operator* op) {
+    if (layers_.count(op->name) > 0) {
+        LOG(ERROR) << "layer [" << op->name << "] already exists";
+        return Status::kFail;
+    }
+
+    const LayerRegistryEntry* layer_registry_entry = GetLayerRegistry(op->type);
+    if (nullptr == layer_registry_entry) {
+        LOG(ERROR) << "layer type [" << op->type << "] not registered";
+        return Status::kEmpty;
+    }
+
+    Layer* layer = layer_registry_entry->creator();
+    if (nullptr == layer) {
+        LOG(ERROR) << "create layer [" << op->type << "] fail";
+        return Status::kFail;
+    }
 
-        layers_[op->name] = layer;
+    // destroyed with the others from now on
+    layers_[op->name] = layer;
+
+    // kernel options are read from context in Init
+    layer->SetContext(context_);
+
+    Status ret = layer->Init(op);
+    if (Status::kSuccess != ret) {
+        LOG(ERROR) << "layer [" << op->name << "] init fail";
+        return ret;
     }
 
     return Status::kSuccess;
@@ -330,10 +432,345 @@ Status EngineImpl::DestroyLayers() {
         layer_registry_entry->destroyer(layer);
     }
 
+    layers_.clear();
+
+    return Status::kSuccess;
+}
+
+Status EngineImpl::CreateTensorLayouts() {
+    const Layout layout = options_.layout;
+    if (Layout::kNHWC == layout) {
+        return Status::kSuccess;
+    }
+
+    LayoutPlanner layout_planner;
+    for (auto& tensor_node_iter : tensor_nodes_) {
+        if (HasLayout(tensor_node_iter.second->tensor)) {
+            layout_planner.AddTensor(tensor_node_iter.first);
+        }
+    }
+
+    for (auto& layer_iter : layers_) {
+        Layer* layer = layer_iter.second;
+
+        if (!layer->SupportLayout(layout)) {
+            layout_planner.SetChoice(layer->GetOp(),
+                                     LayoutPlanner::Choice::kNHWC);
+        } else if (layer->PreferLayout(layout)) {
+            layout_planner.SetChoice(layer->GetOp(),
+                                     LayoutPlanner::Choice::kBlocked);
+        }
+    }
+
+    {
+        Status ret = layout_planner.Plan(graph_);
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "plan tensor layout fail";
+            return ret;
+        }
+    }
+
+    LOG(INFO) << "tensor layout planned, blocks of [" << LayoutBlock(layout)
+              << "] channels, [" << layout_planner.GetReorderCount()
+              << "] reorders";
+
+    // reorders append operands
+    const std::vector<pnnx::Operand*> operands = graph_->operands;
+
+    for (pnnx::Operand* opd : operands) {
+        TensorNode* tensor_node = tensor_nodes_[opd->name];
+        if (!HasLayout(tensor_node->tensor)) {
+            continue;
+        }
+
+        // written in the layout of producer
+        const bool blocked = layout_planner.IsBlocked(opd->producer);
+        if (blocked) {
+            CHECK_STATUS(SetTensorLayout(tensor_node, layout));
+        }
+
+        std::vector<pnnx::Operator*> consumers;
+        for (pnnx::Operator* consumer : opd->consumers) {
+            if (blocked != layout_planner.IsBlocked(consumer) &&
+                consumers.end() ==
+                    std::find(consumers.begin(), consumers.end(), consumer)) {
+                consumers.push_back(consumer);
+            }
+        }
+
+        if (!consumers.empty()) {
+            CHECK_STATUS(CreateReorder(opd,
+                                       consumers,
+                                       blocked ? Layout::kNHWC : layout));
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+Status EngineImpl::SetTensorLayout(TensorNode* tensor_node,
+                                   const Layout layout) {
+    const std::vector<int> shape = tensor_node->tensor.Shape();
+
+    Tensor tensor(tensor_node->tensor.GetDataType(),
+                  LayoutShape(shape, layout),
+                  false);
+    tensor.SetLayout(layout);
+
+    // constants are reordered once at load
+    if (constant_tensor_nodes_.count(tensor_node->operand->name) > 0 &&
+        nullptr != tensor_node->tensor.Data()) {
+        CHECK_STATUS(tensor.Allocate());
+        CHECK_STATUS(ReorderLayout(context_->GetEigenThreadPoolDevice(),
+                                   tensor_node->tensor,
+                                   tensor,
+                                   shape[3]));
+    }
+
+    tensor_node->tensor = std::move(tensor);
+
+    return Status::kSuccess;
+}
+
+Status EngineImpl::CreateReorder(pnnx::Operand* opd,
+                                 const std::vector<pnnx::Operator*>& consumers,
+                                 const Layout layout) {
+    pnnx::Operator* reorder = graph_->new_operator_after("Reorder",
+                                                         "reorder_" + opd->name,
+                                                         opd->producer);
+    pnnx::Operand* output = graph_->new_operand(opd->name + "_reorder");
+
+    output->type     = opd->type;
+    output->shape    = opd->shape;
+    output->producer = reorder;
+
+    reorder->inputs.push_back(opd);
+    reorder->outputs.push_back(output);
+
+    // consumers read the reordered copy instead
+    for (pnnx::Operator* consumer : consumers) {
+        for (pnnx::Operand*& input : consumer->inputs) {
+            if (opd == input) {
+                input = output;
+            }
+        }
+
+        output->consumers.push_back(consumer);
+        opd->consumers.erase(std::remove(opd->consumers.begin(),
+                                         opd->consumers.end(),
+                                         consumer),
+                             opd->consumers.end());
+    }
+
+    opd->consumers.push_back(reorder);
+
+    TensorNode* tensor_node = new TensorNode;
+    tensor_node->operand    = output;
+    tensor_node->tensor     = Tensor(PnnxToDataType(output->type),
+                                 LayoutShape(PnnxToNHWCShape(output->shape),
+                                             layout),
+                                 false);
+    tensor_node->tensor.SetLayout(layout);
+
+    tensor_nodes_[output->name] = tensor_node;
+
+    // graph outputs are extracted from the NHWC copy
+    for (const pnnx::Operator* consumer : consumers) {
+        if ("pnnx.Output" == consumer->type) {
+            output_tensor_nodes_[opd->name] = tensor_node;
+        }
+    }
+
+    CHECK_STATUS(CreateLayer(reorder));
+
+    LOG(INFO) << "tensor [" << opd->name << "] reordered for ["
+              << consumers.size() << "] consumers";
+
+    return Status::kSuccess;
+}
+
+Status EngineImpl::CreateTensorAliases() {
+    // in-place layers, output reuse memory of input
+    for (auto& layer_iter : layers_) {
+        Layer* layer             = layer_iter.second;
+        const pnnx::Operator* op = layer->GetOp();
+
+        if (!layer->SupportInplace() || 1 != op->inputs.size() ||
+            1 != op->outputs.size()) {
+            continue;
+        }
+
+        const pnnx::Operand* input  = op->inputs[0];
+        const pnnx::Operand* output = op->outputs[0];
+
+        // other consumers still need the input after this layer
+        if (1 != input->consumers.size()) {
+            continue;
+        }
+
+        // never overwrite user memory or constants
+        if (input_tensor_nodes_.count(input->name) > 0 ||
+            constant_tensor_nodes_.count(input->name) > 0) {
+            continue;
+        }
+
+        TensorNode* input_node  = tensor_nodes_[input->name];
+        TensorNode* output_node = tensor_nodes_[output->name];
+
+        if (nullptr != output_node->alias ||
+            input_node->tensor.GetDataType() !=
+                output_node->tensor.GetDataType() ||
+            TensorSize(input_node->tensor) != TensorSize(output_node->tensor)) {
+            continue;
+        }
+
+        output_node->alias        = input_node;
+        output_node->alias_offset = 0;
+
+        LOG(INFO) << "layer [" << op->name << "] run in place";
+    }
+
+    // reshape only layers, output is a view of input
+    for (auto& layer_iter : layers_) {
+        Layer* layer             = layer_iter.second;
+        const pnnx::Operator* op = layer->GetOp();
+
+        if (!layer->IsReshapeOnly() || 1 != op->inputs.size() ||
+            1 != op->outputs.size()) {
+            continue;
+        }
+
+        const pnnx::Operand* input  = op->inputs[0];
+        const pnnx::Operand* output = op->outputs[0];
+
+        // in-place consumers of output would overwrite input of others
+        if (1 != input->consumers.size()) {
+            continue;
+        }
+
+        if (input_tensor_nodes_.count(input->name) > 0 ||
+            constant_tensor_nodes_.count(input->name) > 0) {
+            continue;
+        }
+
+        TensorNode* input_node  = tensor_nodes_[input->name];
+        TensorNode* output_node = tensor_nodes_[output->name];
+
+        if (nullptr != output_node->alias ||
+            !input_node->tensor.IsContiguous() ||
+            input_node->tensor.GetDataType() !=
+                output_node->tensor.GetDataType() ||
+            TensorSize(input_node->tensor) != TensorSize(output_node->tensor)) {
+            continue;
+        }
+
+        output_node->alias        = input_node;
+        output_node->alias_offset = 0;
+
+        LOG(INFO) << "layer [" << op->name << "] output is a view of input";
+    }
+
+    // channel concat, producers write into output directly
+    for (auto& layer_iter : layers_) {
+        Layer* layer             = layer_iter.second;
+        const pnnx::Operator* op = layer->GetOp();
+
+        if ("torch.cat" != op->type) {
+            continue;
+        }
+
+        const int dim           = static_cast<Cat*>(layer)->dim_;
+        TensorNode* output_node = tensor_nodes_[op->outputs[0]->name];
+
+        const std::vector<int>& output_shape = output_node->tensor.Shape();
+        const int element_size = ElementSize(output_node->tensor.GetDataType());
+
+        // NCHW dim 1 is the last dimension of NHWC
+        if (4 != output_shape.size() || 1 != dim) {
+            continue;
+        }
+
+        int channel_offset = 0;
+        for (const pnnx::Operand* input : op->inputs) {
+            TensorNode* input_node = tensor_nodes_[input->name];
+            const int channel      = input_node->tensor.Shape().back();
+
+            if (IsChannelViewSupported(input_node, output_node)) {
+                TensorNode* root_node = input_node;
+                while (true) {
+                    root_node->tensor.SetRowStride(output_shape[3]);
+
+                    if (nullptr == root_node->alias) {
+                        break;
+                    }
+
+                    root_node = root_node->alias;
+                }
+
+                root_node->alias        = output_node;
+                root_node->alias_offset = channel_offset * element_size;
+
+                LOG(INFO) << "tensor [" << input->name
+                          << "] write into concat [" << op->name << "]";
+            }
+
+            channel_offset += channel;
+        }
+    }
+
     return Status::kSuccess;
 }
 
+bool EngineImpl::IsChannelViewSupported(const TensorNode* tensor_node,
+                                        const TensorNode* concat_node) {
+    const std::vector<int>& shape        = tensor_node->tensor.Shape();
+    const std::vector<int>& concat_shape = concat_node->tensor.Shape();
+
+    if (4 != shape.size() || shape[0] != concat_shape[0] ||
+        shape[1] != concat_shape[1] || shape[2] != concat_shape[2]) {
+        return false;
+    }
+
+    // every layer writing the in-place chain must handle the view
+    while (nullptr != tensor_node) {
+        const pnnx::Operand* operand = tensor_node->operand;
+
+        if (1 != operand->consumers.size() ||
+            input_tensor_nodes_.count(operand->name) > 0 ||
+            layers_.count(operand->producer->name) <= 0) {
+            return false;
+        }
+
+        if (!layers_[operand->producer->name]->SupportStridedOutput() ||
+            !IsSameShape(tensor_node->tensor.Shape(), shape) ||
+            tensor_node->tensor.GetDataType() !=
+                concat_node->tensor.GetDataType()) {
+            return false;
+        }
+
+        tensor_node = tensor_node->alias;
+    }
+
+    return true;
+}
+
 Status EngineImpl::CreatePipeline() {
+    if (options_.enable_profile) {
+        profiler_.reset(new Profiler);
+    }
+
+    if (PipelineType::kSequential == options_.pipeline_type) {
+        return CreateSequence();
+    }
+
+    if (PipelineType::kCostModel == options_.pipeline_type) {
+        CHECK_STATUS(CreateSequence());
+
+        return scheduler_.Init(sequence_,
+                               context_,
+                               options_.num_pipeline_threads);
+    }
+
     pipeline_ = CGraph::GPipelineFactory::create();
     if (nullptr == pipeline_) {
         LOG(ERROR) << "create pipeline fail";
@@ -359,6 +796,7 @@ Status EngineImpl::CreatePipeline() {
 
         PipelineNode* node = static_cast<PipelineNode*>(element);
         node->SetLayer(layer);
+        node->SetProfiler(profiler_.get());
         node->setName(layer_name);
         pipeline_nodes_[layer_name] = node;
     }
@@ -367,7 +805,8 @@ Status EngineImpl::CreatePipeline() {
         TensorNode* tensor_node = tensor_node_iter.second;
 
         pnnx::Operator* producer = tensor_node->operand->producer;
-        if ("pnnx.Input" == producer->type) {
+        if (nullptr == producer || "pnnx.Input" == producer->type ||
+            "pnnx.Attribute" == producer->type) {
             continue;
         }
 
@@ -403,24 +842,36 @@ Status EngineImpl::CreatePipeline() {
 
     {
         // pipiline config
-        pipeline_->setGEngineType(CGraph::GEngineType::STATIC);
+        if (PipelineType::kDynamic == options_.pipeline_type) {
+            pipeline_->setGEngineType(CGraph::GEngineType::DYNAMIC);
+        } else {
+            pipeline_->setGEngineType(CGraph::GEngineType::STATIC);
+        }
 
-#if 0
-        CSize size;
-        CStatus ret = pipeline_->calcMaxPara(size);
-        if (!ret.isOK()) {
-            LOG(ERROR) << "pipeline calcMaxPara fail";
-            return Status::kFail;
+        int num_threads = options_.num_pipeline_threads;
+        if (num_threads <= 0) {
+            CSize size = 0;
+            CStatus ret = pipeline_->calcMaxPara(size);
+            if (!ret.isOK()) {
+                LOG(ERROR) << "pipeline calcMaxPara fail";
+                return Status::kFail;
+            }
+
+            LOG(INFO) << "pipeline calcMaxPara size [" << size << "]";
+
+            num_threads = (int)size;
         }
 
-        LOG(INFO) << "pipeline calcMaxPara size [" << size << "]";
+        // pipeline threads only drive layers, kernels run on the shared pool
+        // of context, keep them within its core budget
+        const int max_threads =
+            context_->GetEigenThreadPoolDevice()->numThreads();
+        num_threads = (std::max)((std::min)(num_threads, max_threads), 1);
+
+        LOG(INFO) << "inter-op threads [" << num_threads << "]";
 
-        pipeline_thread_pool_config_.default_thread_size_ = (int)size;
-        pipeline_thread_pool_config_.max_thread_size_     = (int)size;
-#else
-        pipeline_thread_pool_config_.default_thread_size_ = 2;
-        pipeline_thread_pool_config_.max_thread_size_     = 2;
-#endif
+        pipeline_thread_pool_config_.default_thread_size_ = num_threads;
+        pipeline_thread_pool_config_.max_thread_size_     = num_threads;
 
         pipeline_->setUniqueThreadPoolConfig(pipeline_thread_pool_config_);
     }
@@ -436,9 +887,116 @@ Status EngineImpl::CreatePipeline() {
     return Status::kSuccess;
 }
 
+Status EngineImpl::CreateSequence() {
+    const int num_ops = (int)graph_->ops.size();
+
+    // keep the graph order when it is already topological
+    std::vector<bool> visited(num_ops, false);
+    std::set<const pnnx::Operator*> finished;
+
+    while (sequence_.size() < layers_.size()) {
+        bool progress = false;
+
+        for (int i = 0; i < num_ops; ++i) {
+            const pnnx::Operator* op = graph_->ops[i];
+            if (visited[i] || layers_.count(op->name) <= 0) {
+                continue;
+            }
+
+            bool ready = true;
+            for (const pnnx::Operand* input : op->inputs) {
+                // graph inputs and constants are ready from the start
+                const pnnx::Operator* producer = input->producer;
+                if (nullptr != producer && "pnnx.Input" != producer->type &&
+                    "pnnx.Attribute" != producer->type &&
+                    finished.count(producer) <= 0) {
+                    ready = false;
+                    break;
+                }
+            }
+
+            if (!ready) {
+                continue;
+            }
+
+            visited[i] = true;
+            finished.insert(op);
+
+            sequence_.push_back(layers_[op->name]);
+
+            progress = true;
+        }
+
+        if (!progress) {
+            LOG(ERROR) << "create sequence fail [graph has cycle]";
+            return Status::kFail;
+        }
+    }
+
+    LOG(INFO) << "sequence of [" << sequence_.size() << "] layers";
+
+    return Status::kSuccess;
+}
+
+Status EngineImpl::CreatePartialSequence(
+    const std::set<std::string>& output_names,
+    std::vector<Layer*>& sequence) {
+    // graph pipelines have no sequence, it is only needed here
+    if (sequence_.empty()) {
+        CHECK_STATUS(CreateSequence());
+    }
+
+    // walk back from outputs, arena plan stays valid for any ancestor closed
+    // subset of layers, see MemoryPlanner
+    std::set<const pnnx::Operator*> ancestors;
+    std::vector<const pnnx::Operator*> stack;
+    for (const std::string& name : output_names) {
+        if (output_tensor_nodes_.count(name) <= 0) {
+            LOG(ERROR) << "tensor [" << name << "] is not an output tensor";
+            return Status::kFail;
+        }
+
+        const pnnx::Operator* producer =
+            output_tensor_nodes_[name]->operand->producer;
+        if (ancestors.insert(producer).second) {
+            stack.push_back(producer);
+        }
+    }
+
+    while (!stack.empty()) {
+        const pnnx::Operator* op = stack.back();
+        stack.pop_back();
+
+        for (const pnnx::Operand* input : op->inputs) {
+            const pnnx::Operator* producer = input->producer;
+            if (nullptr != producer && ancestors.insert(producer).second) {
+                stack.push_back(producer);
+            }
+        }
+    }
+
+    sequence.clear();
+    for (Layer* layer : sequence_) {
+        if (ancestors.count(layer->GetOp()) > 0) {
+            sequence.push_back(layer);
+        }
+    }
+
+    LOG(INFO) << "partial sequence of [" << sequence.size() << "] layers";
+
+    return Status::kSuccess;
+}
+
 Status EngineImpl::DestroyPipeline() {
     pipeline_nodes_.clear();
 
+    sequence_.clear();
+    partial_sequences_.clear();
+
+    scheduler_.Deinit();
+
+    profiler_.reset();
+
     if (nullptr != pipeline_) {
         {
             CStatus ret = pipeline_->destroy();
@@ -463,37 +1021,102 @@ Status EngineImpl::DestroyPipeline() {
 }
 
 Status EngineImpl::AllocateTensorMemory() {
-    // TODO: memory reuse
+    MemoryPlanner memory_planner;
     for (auto& tensor_node_iter : tensor_nodes_) {
-        if (input_tensor_nodes_.count(tensor_node_iter.first) > 0) {
-            // input tensor use external memory
-            continue;
+        const TensorNode* tensor_node = tensor_node_iter.second;
+        if (nullptr != tensor_node->alias) {
+            memory_planner.SetAlias(tensor_node_iter.first,
+                                    tensor_node->alias->operand->name,
+                                    tensor_node->alias_offset);
+        }
+
+        // padded channel blocks
+        if (Layout::kNHWC != tensor_node->tensor.GetLayout()) {
+            memory_planner.SetSize(tensor_node_iter.first,
+                                   TensorSize(tensor_node->tensor));
+        }
+    }
+
+    {
+        Status ret = memory_planner.Plan(graph_);
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "plan tensor memory fail";
+            return ret;
+        }
+    }
+
+    LOG(INFO) << "tensor memory planned peak ["
+              << memory_planner.GetPeakSize() << "] bytes, naive ["
+              << memory_planner.GetNaiveSize() << "] bytes";
+
+    {
+        Status ret = tensor_arena_.Reserve(memory_planner.GetPeakSize());
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "reserve tensor memory fail";
+            return ret;
         }
+    }
 
-        Status ret = tensor_node_iter.second->tensor.Allocate();
+    output_blocks_.clear();
+    for (const auto& pinned_size_iter : memory_planner.GetPinnedSizes()) {
+        Status ret = output_blocks_[pinned_size_iter.first].Reserve(
+            pinned_size_iter.second);
         if (Status::kSuccess != ret) {
-            LOG(ERROR) << "allocate tensor [" << tensor_node_iter.first
+            LOG(ERROR) << "reserve output [" << pinned_size_iter.first
                        << "] memory fail";
             return ret;
         }
     }
 
-    return Status::kSuccess;
+    if (first_touch_) {
+        TouchTensorMemory();
+    }
+
+    for (auto& tensor_node_iter : tensor_nodes_) {
+        if (input_tensor_nodes_.count(tensor_node_iter.first) > 0 ||
+            constant_tensor_nodes_.count(tensor_node_iter.first) > 0) {
+            // input tensor use external memory, constant its own
+            continue;
+        }
+
+        if (!memory_planner.HasOffset(tensor_node_iter.first)) {
+            LOG(ERROR) << "tensor [" << tensor_node_iter.first
+                       << "] not planned";
+            return Status::kFail;
+        }
+
+        const std::string& name = tensor_node_iter.first;
+        TensorNode* tensor_node = tensor_node_iter.second;
+
+        tensor_node->memory_offset = memory_planner.GetOffset(name);
+        tensor_node->block =
+            memory_planner.IsPinned(name)
+                ? &output_blocks_[memory_planner.GetPinnedRoot(name)]
+                : nullptr;
+    }
+
+    return BindTensorMemory();
 }
 
-Status EngineImpl::DeallocateTensorMemory() {
+Status EngineImpl::BindTensorMemory() {
     for (auto& tensor_node_iter : tensor_nodes_) {
-        if (input_tensor_nodes_.count(tensor_node_iter.first) > 0) {
-            // input tensor use external memory
+        if (input_tensor_nodes_.count(tensor_node_iter.first) > 0 ||
+            constant_tensor_nodes_.count(tensor_node_iter.first) > 0) {
             continue;
         }
 
         TensorNode* tensor_node = tensor_node_iter.second;
 
-        Status ret = tensor_node->tensor.Deallocate();
+        const MemoryArena& memory = (nullptr != tensor_node->block)
+                                        ? *tensor_node->block
+                                        : tensor_arena_;
+
+        // nodes do not hold a reference, only extracted outputs do
+        Status ret = tensor_node->tensor.SetData(
+            memory.Data(tensor_node->memory_offset));
         if (Status::kSuccess != ret) {
-            LOG(ERROR) << "deallocate tensor memory ["
-                       << tensor_node->operand->name << "] fail";
+            LOG(ERROR) << "set tensor [" << tensor_node_iter.first
+                       << "] memory fail";
             return ret;
         }
     }
@@ -501,6 +1124,67 @@ Status EngineImpl::DeallocateTensorMemory() {
     return Status::kSuccess;
 }
 
+Status EngineImpl::RenewOutputBlocks() {
+    bool renewed = false;
+    for (auto& output_block_iter : output_blocks_) {
+        MemoryArena& output_block = output_block_iter.second;
+        if (output_block.IsShared()) {
+            // a shared block is never reused, Reserve() allocates a new one
+            CHECK_STATUS(output_block.Reserve(output_block.Size()));
+            renewed = true;
+        }
+    }
+
+    return renewed ? BindTensorMemory() : Status::kSuccess;
+}
+
+void EngineImpl::TouchTensorMemory() {
+    static const size_t kPageSize = 4096;
+
+    Eigen::ThreadPoolDevice* device = context_->GetEigenThreadPoolDevice();
+
+    char* data        = static_cast<char*>(tensor_arena_.Data());
+    const size_t size = tensor_arena_.Size();
+
+    // whole pages per pool thread. Unlike Parallel(), no block runs on the
+    // calling thread, which is not pinned
+    const size_t num_blocks = (size_t)(std::max)(device->numThreads(), 1);
+
+    size_t block_size = (size + num_blocks - 1) / num_blocks;
+    block_size        = (block_size + kPageSize - 1) / kPageSize * kPageSize;
+
+    Eigen::Barrier barrier((unsigned int)num_blocks);
+    for (size_t block = 0; block < num_blocks; ++block) {
+        const size_t begin = (std::min)(block * block_size, size);
+        const size_t end   = (std::min)(begin + block_size, size);
+
+        device->enqueue_with_barrier(&barrier, [data, begin, end] {
+            memset(data + begin, 0, end - begin);
+        });
+    }
+
+    barrier.Wait();
+}
+
+Status EngineImpl::DeallocateTensorMemory() {
+    // tensor nodes only borrow the arena, nothing to free one by one, but
+    // none of them may keep pointing into the released block
+    for (auto& tensor_node_iter : tensor_nodes_) {
+        if (input_tensor_nodes_.count(tensor_node_iter.first) > 0 ||
+            constant_tensor_nodes_.count(tensor_node_iter.first) > 0) {
+            continue;
+        }
+
+        tensor_node_iter.second->tensor.SetData(nullptr);
+        tensor_node_iter.second->block = nullptr;
+    }
+
+    tensor_arena_.Release();
+    output_blocks_.clear();
+
+    return Status::kSuccess;
+}
+
 const std::vector<std::string> EngineImpl::InputNames() {
     std::vector<std::string> ret;
     for (auto& input_tensor_node_iter : input_tensor_nodes_) {
@@ -531,7 +1215,20 @@ Status EngineImpl::Input(const std::string& name, const Tensor& input) {
 }
 
 Status EngineImpl::Forward() {
-    // TODO: add runtime options
+    CHECK_STATUS(RenewOutputBlocks());
+
+    if (nullptr != profiler_) {
+        profiler_->BeginRun();
+    }
+
+    if (PipelineType::kSequential == options_.pipeline_type) {
+        return RunSequence(sequence_);
+    }
+
+    if (PipelineType::kCostModel == options_.pipeline_type) {
+        return scheduler_.Run(profiler_.get());
+    }
+
     {
         CStatus ret = pipeline_->run();
         if (!ret.isOK()) {
@@ -543,13 +1240,110 @@ Status EngineImpl::Forward() {
     return Status::kSuccess;
 }
 
+Status EngineImpl::Forward(const std::vector<std::string>& output_names) {
+    const std::set<std::string> output_set(output_names.begin(),
+                                           output_names.end());
+
+    auto iter = partial_sequences_.find(output_set);
+    if (partial_sequences_.end() == iter) {
+        std::vector<Layer*> sequence;
+        CHECK_STATUS(CreatePartialSequence(output_set, sequence));
+
+        iter =
+            partial_sequences_.emplace(output_set, std::move(sequence)).first;
+    }
+
+    CHECK_STATUS(RenewOutputBlocks());
+
+    if (nullptr != profiler_) {
+        profiler_->BeginRun();
+    }
+
+    return RunSequence(iter->second);
+}
+
+Status EngineImpl::RunSequence(const std::vector<Layer*>& sequence) {
+    for (Layer* layer : sequence) {
+        Status ret = (nullptr == profiler_) ? layer->Forward()
+                                            : profiler_->Forward(layer);
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "layer [" << layer->GetOp()->name
+                       << "] forward fail";
+            return ret;
+        }
+    }
+
+    return Status::kSuccess;
+}
+
 Status EngineImpl::Extract(const std::string& name, Tensor& output) {
     if (output_tensor_nodes_.count(name) <= 0) {
         LOG(ERROR) << "tensor [" << name << "] is not an output tensor";
         return Status::kFail;
     }
 
-    output = output_tensor_nodes_[name]->tensor;
+    const TensorNode* tensor_node = output_tensor_nodes_[name];
+
+    // zero copy, output shares the block, see RenewOutputBlocks. Node of a
+    // reordered output is the NHWC copy, not the named tensor
+    if (nullptr != tensor_node->block) {
+        output = tensor_node->tensor;
+
+        return output.SetData(tensor_node->block->Storage(),
+                              tensor_node->memory_offset);
+    }
+
+    // graph input or constant, the caller must not write into them
+    Status ret = tensor_node->tensor.CopyTo(output);
+    if (Status::kSuccess != ret) {
+        LOG(ERROR) << "copy tensor [" << name << "] fail";
+        return ret;
+    }
+
+    return Status::kSuccess;
+}
+
+const MemoryArena& EngineImpl::GetTensorArena() const {
+    return tensor_arena_;
+}
+
+const TensorNode* EngineImpl::GetTensorNode(const std::string& name) const {
+    auto tensor_node_iter = tensor_nodes_.find(name);
+    if (tensor_nodes_.end() == tensor_node_iter) {
+        return nullptr;
+    }
+
+    return tensor_node_iter->second;
+}
+
+const Profiler* EngineImpl::GetProfiler() const {
+    return profiler_.get();
+}
+
+Status EngineImpl::SaveProfile(const std::string& path) {
+    if (nullptr == profiler_) {
+        LOG(ERROR) << "profiling is not enabled";
+        return Status::kErrorContext;
+    }
+
+    return profiler_->SaveChromeTrace(path);
+}
+
+const std::string EngineImpl::ProfileSummary() {
+    if (nullptr == profiler_) {
+        return std::string();
+    }
+
+    return profiler_->Summary();
+}
+
+Status EngineImpl::ClearProfile() {
+    if (nullptr == profiler_) {
+        LOG(ERROR) << "profiling is not enabled";
+        return Status::kErrorContext;
+    }
+
+    profiler_->Clear();
 
     return Status::kSuccess;
 }
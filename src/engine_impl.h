@@ -2,14 +2,20 @@
 #define SIMPLE_INFER_SRC_ENGINE_IMPL_H_
 
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <CGraph.h>
 
 #include "context.h"
 #include "layer.h"
+#include "memory_arena.h"
 #include "pipeline_node.h"
 #include "pnnx/pnnx_helper.h"
+#include "profiler.h"
+#include "scheduler.h"
 #include "tensor.h"
 #include "tensor_node.h"
 #include "types.h"
@@ -23,7 +29,9 @@ public:
     ~EngineImpl();
 
 public:
-    Status LoadModel(const std::string& parampath, const std::string& binpath);
+    Status LoadModel(const std::string& parampath,
+                     const std::string& binpath,
+                     const EngineOptions& options);
 
     Status Release();
 
@@ -40,12 +48,49 @@ public:
     Status CreateLayers();
     Status DestroyLayers();
 
+    // create, set context and init, tensor nodes are connected later
+    Status CreateLayer(const pnnx::Operator* op);
+
+    // layout of every rank 4 activation, see LayoutPlanner
+    Status CreateTensorLayouts();
+
+    Status SetTensorLayout(TensorNode* tensor_node, const Layout layout);
+
+    // consumers read opd through a new Reorder layer which writes layout
+    Status CreateReorder(pnnx::Operand* opd,
+                         const std::vector<pnnx::Operator*>& consumers,
+                         const Layout layout);
+
+    Status CreateTensorAliases();
+
+    bool IsChannelViewSupported(const TensorNode* tensor_node,
+                                const TensorNode* concat_node);
+
     Status CreatePipeline();
     Status DestroyPipeline();
 
+    // topological order of layers for PipelineType::kSequential and
+    // PipelineType::kCostModel
+    Status CreateSequence();
+    Status RunSequence(const std::vector<Layer*>& sequence);
+
+    // layers of sequence_ the outputs depend on
+    Status CreatePartialSequence(const std::set<std::string>& output_names,
+                                 std::vector<Layer*>& sequence);
+
     Status AllocateTensorMemory();
     Status DeallocateTensorMemory();
 
+    // point tensor nodes into current arena and output blocks
+    Status BindTensorMemory();
+
+    // output blocks still held by a caller are left to it, the next run
+    // writes fresh ones
+    Status RenewOutputBlocks();
+
+    // write arena pages from the pool, so they are local to its threads
+    void TouchTensorMemory();
+
 public:
     const std::vector<std::string> InputNames();
     const std::vector<std::string> OutputNames();
@@ -55,9 +100,30 @@ public:
 
     Status Forward();
 
+    Status Forward(const std::vector<std::string>& output_names);
+
     Status Extract(const std::string& name, Tensor& output);
 
+public:
+    // backs every tensor except inputs, constants and output blocks
+    const MemoryArena& GetTensorArena() const;
+
+    // nullptr if there is no tensor [name]
+    const TensorNode* GetTensorNode(const std::string& name) const;
+
+    // nullptr unless profiling is enabled
+    const Profiler* GetProfiler() const;
+
+public:
+    Status SaveProfile(const std::string& path);
+
+    const std::string ProfileSummary();
+
+    Status ClearProfile();
+
 private:
+    EngineOptions options_;
+
     Context* context_ = nullptr;
 
     pnnx::Graph* graph_ = nullptr;
@@ -68,9 +134,30 @@ private:
     std::map<std::string, TensorNode*> input_tensor_nodes_;
     std::map<std::string, TensorNode*> output_tensor_nodes_;
 
+    // outputs of pnnx.Attribute, hold their own memory outside the arena
+    std::map<std::string, TensorNode*> constant_tensor_nodes_;
+
+    // all non-input tensors are sub-views of it, see MemoryPlanner
+    MemoryArena tensor_arena_;
+    bool first_touch_ = false;
+
+    // graph outputs and the tensors aliased into them, a block per root
+    // operand, so Extract can share it without pinning the arena
+    std::map<std::string, MemoryArena> output_blocks_;
+
     CGraph::GPipelinePtr pipeline_ = nullptr;
     CGraph::UThreadPoolConfig pipeline_thread_pool_config_;
     std::map<std::string, PipelineNode*> pipeline_nodes_;
+
+    std::vector<Layer*> sequence_;
+
+    // pruned sequences of Forward(output_names), by output set
+    std::map<std::set<std::string>, std::vector<Layer*>> partial_sequences_;
+
+    Scheduler scheduler_;
+
+    // only created when profiling is enabled
+    std::unique_ptr<Profiler> profiler_;
 };
 
 }  // namespace SimpleInfer
@@ -0,0 +1,477 @@
+#include "graph_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "layer.h"
+#include "layer/simd/activation.h"
+#include "layer_registry.h"
+#include "logger.h"
+#include "pnnx/pnnx_helper.h"
+#include "tensor_node.h"
+
+namespace SimpleInfer {
+
+static void RemoveOperator(pnnx::Graph* graph, pnnx::Operator* op) {
+    graph->ops.erase(std::find(graph->ops.begin(), graph->ops.end(), op));
+
+    delete op;
+}
+
+static void RemoveOperand(pnnx::Graph* graph, pnnx::Operand* operand) {
+    graph->operands.erase(
+        std::find(graph->operands.begin(), graph->operands.end(), operand));
+
+    delete operand;
+}
+
+// f32 attribute of size elements
+static bool IsFloatAttr(const pnnx::Operator* op,
+                        const std::string& name,
+                        const size_t size) {
+    if (!CheckAttr(op, name, 1)) {
+        return false;
+    }
+
+    return (op->attrs.at(name).data.size() == size * sizeof(float));
+}
+
+static const float* GetFloatAttr(const pnnx::Operator* op,
+                                 const std::string& name) {
+    return reinterpret_cast<const float*>(op->attrs.at(name).data.data());
+}
+
+Status OptimizeGraph(pnnx::Graph* graph) {
+    if (nullptr == graph) {
+        return Status::kEmpty;
+    }
+
+    CHECK_STATUS(EliminateDeadOperators(graph));
+
+    // folded operators may leave their constant inputs unused
+    CHECK_STATUS(FoldConstants(graph));
+
+    CHECK_STATUS(EliminateDeadOperators(graph));
+
+    CHECK_STATUS(FuseConv2dBatchNorm2d(graph));
+
+    // after batch norm folding, conv -> bn -> act becomes conv -> act
+    CHECK_STATUS(FuseConv2dActivation(graph));
+
+    CHECK_STATUS(FuseConv2dResidual(graph));
+
+    // activation after the residual add, e.g. resnet blocks
+    CHECK_STATUS(FuseConv2dActivation(graph));
+
+    return Status::kSuccess;
+}
+
+Status EliminateDeadOperators(pnnx::Graph* graph) {
+    // walk back from graph outputs
+    std::set<const pnnx::Operator*> live;
+    std::vector<const pnnx::Operator*> stack;
+    for (const pnnx::Operator* op : graph->ops) {
+        if ("pnnx.Output" == op->type) {
+            live.insert(op);
+            stack.push_back(op);
+        } else if ("pnnx.Input" == op->type) {
+            live.insert(op);
+        }
+    }
+
+    // a graph without outputs keeps everything, e.g. a partial graph
+    if (stack.empty()) {
+        return Status::kSuccess;
+    }
+
+    while (!stack.empty()) {
+        const pnnx::Operator* op = stack.back();
+        stack.pop_back();
+
+        for (const pnnx::Operand* input : op->inputs) {
+            const pnnx::Operator* producer = input->producer;
+            if (nullptr != producer && live.insert(producer).second) {
+                stack.push_back(producer);
+            }
+        }
+    }
+
+    std::vector<pnnx::Operator*> dead;
+    for (pnnx::Operator* op : graph->ops) {
+        if (live.count(op) <= 0) {
+            dead.push_back(op);
+        }
+    }
+
+    // detach from live operands, consumers of dead outputs are dead as well
+    for (pnnx::Operator* op : dead) {
+        for (pnnx::Operand* input : op->inputs) {
+            if (nullptr == input->producer ||
+                live.count(input->producer) > 0) {
+                input->remove_consumer(op);
+            }
+        }
+    }
+
+    for (pnnx::Operator* op : dead) {
+        for (pnnx::Operand* output : op->outputs) {
+            RemoveOperand(graph, output);
+        }
+
+        RemoveOperator(graph, op);
+    }
+
+    LOG(INFO) << "eliminate dead operators [" << dead.size() << "]";
+
+    return Status::kSuccess;
+}
+
+// run op on its constant inputs with a temporary layer, nothing is changed
+// when the layer fails
+static Status EvaluateConstant(const pnnx::Operator* op, Tensor& output) {
+    const LayerRegistryEntry* layer_registry_entry = GetLayerRegistry(op->type);
+    if (nullptr == layer_registry_entry) {
+        return Status::kUnsupport;
+    }
+
+    std::vector<TensorNode> tensor_nodes(op->inputs.size() + 1);
+    std::vector<TensorNode*> input_tensor_nodes;
+    for (size_t j = 0; j < op->inputs.size(); ++j) {
+        const pnnx::Attribute* attr = GetConstantAttr(op->inputs[j]->producer);
+
+        tensor_nodes[j].operand = op->inputs[j];
+        CHECK_STATUS(AttributeToTensor(*attr, tensor_nodes[j].tensor));
+
+        input_tensor_nodes.push_back(&tensor_nodes[j]);
+    }
+
+    TensorNode* output_tensor_node = &tensor_nodes.back();
+    output_tensor_node->operand    = op->outputs[0];
+    output_tensor_node->tensor     = Tensor(DataType::kFloat32,
+                                        PnnxToNHWCShape(op->outputs[0]->shape),
+                                        true);
+
+    Layer* layer = layer_registry_entry->creator();
+    if (nullptr == layer) {
+        return Status::kFail;
+    }
+
+    // no context, kernels run on the default device
+    Status ret = layer->Init(op);
+    if (Status::kSuccess == ret) {
+        layer->SetInputNodes(input_tensor_nodes);
+        layer->SetOutputNodes({output_tensor_node});
+
+        ret = layer->Validate();
+    }
+
+    if (Status::kSuccess == ret) {
+        ret = layer->Forward();
+    }
+
+    layer->Deinit();
+    layer_registry_entry->destroyer(layer);
+
+    output = output_tensor_node->tensor;
+
+    return ret;
+}
+
+static bool IsConstantFoldable(const pnnx::Operator* op) {
+    if ("pnnx.Input" == op->type || "pnnx.Output" == op->type ||
+        "pnnx.Attribute" == op->type || op->inputs.empty() ||
+        1 != op->outputs.size()) {
+        return false;
+    }
+
+    const pnnx::Operand* output = op->outputs[0];
+    if (1 != output->type || output->shape.empty()) {
+        return false;
+    }
+
+    for (const int s : output->shape) {
+        if (s <= 0) {
+            return false;
+        }
+    }
+
+    for (const pnnx::Operand* input : op->inputs) {
+        // only f32 constants are evaluated, others stay as they are
+        const pnnx::Operator* producer = input->producer;
+        if (nullptr == producer || 1 != input->type) {
+            return false;
+        }
+
+        const pnnx::Attribute* attr = GetConstantAttr(producer);
+        if (nullptr == attr || 1 != attr->type) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Status FoldConstants(pnnx::Graph* graph) {
+    int num_folded = 0;
+
+    // ops are not always in topological order, repeat until nothing changes
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        for (pnnx::Operator* op : graph->ops) {
+            if (!IsConstantFoldable(op)) {
+                continue;
+            }
+
+            Tensor output;
+            if (Status::kSuccess != EvaluateConstant(op, output)) {
+                LOG(WARNING) << "fold constant [" << op->name << "] skipped";
+                continue;
+            }
+
+            pnnx::Attribute data;
+            CHECK_STATUS(TensorToAttribute(output, data));
+
+            for (pnnx::Operand* input : op->inputs) {
+                input->remove_consumer(op);
+            }
+
+            op->type = "pnnx.Attribute";
+            op->inputs.clear();
+            op->inputnames.clear();
+            op->params.clear();
+            op->attrs.clear();
+            op->attrs["data"] = data;
+
+            progress = true;
+            ++num_folded;
+        }
+    }
+
+    LOG(INFO) << "fold constants [" << num_folded << "]";
+
+    return Status::kSuccess;
+}
+
+Status FuseConv2dBatchNorm2d(pnnx::Graph* graph) {
+    int num_fused = 0;
+
+    // graph->ops changes in loop
+    for (size_t i = 0; i < graph->ops.size(); ++i) {
+        pnnx::Operator* batch_norm = graph->ops[i];
+        if ("nn.BatchNorm2d" != batch_norm->type ||
+            1 != batch_norm->inputs.size() || 1 != batch_norm->outputs.size()) {
+            continue;
+        }
+
+        pnnx::Operand* conv_output = batch_norm->inputs[0];
+        pnnx::Operator* conv       = conv_output->producer;
+        if (nullptr == conv || "nn.Conv2d" != conv->type ||
+            1 != conv->inputs.size() || 1 != conv->outputs.size() ||
+            1 != conv_output->consumers.size()) {
+            continue;
+        }
+
+        if (!CheckParam(conv, "out_channels", 2) ||
+            !CheckParam(conv, "bias", 1) ||
+            !CheckParam(batch_norm, "num_features", 2) ||
+            !CheckParam(batch_norm, "eps", 3) ||
+            !CheckParam(batch_norm, "affine", 1)) {
+            continue;
+        }
+
+        const int channels = conv->params.at("out_channels").i;
+        if (channels != batch_norm->params.at("num_features").i) {
+            continue;
+        }
+
+        const bool use_bias   = conv->params.at("bias").b;
+        const bool use_affine = batch_norm->params.at("affine").b;
+
+        if (!CheckAttr(conv, "weight", 1) ||
+            (use_bias && !IsFloatAttr(conv, "bias", channels)) ||
+            !IsFloatAttr(batch_norm, "running_mean", channels) ||
+            !IsFloatAttr(batch_norm, "running_var", channels) ||
+            (use_affine && (!IsFloatAttr(batch_norm, "weight", channels) ||
+                            !IsFloatAttr(batch_norm, "bias", channels)))) {
+            continue;
+        }
+
+        const float eps   = batch_norm->params.at("eps").f;
+        const float* mean = GetFloatAttr(batch_norm, "running_mean");
+        const float* var  = GetFloatAttr(batch_norm, "running_var");
+
+        const float* gamma = nullptr;
+        const float* beta  = nullptr;
+        if (use_affine) {
+            gamma = GetFloatAttr(batch_norm, "weight");
+            beta  = GetFloatAttr(batch_norm, "bias");
+        }
+
+        // weight OIHW, scale each output channel
+        pnnx::Attribute& weight = conv->attrs.at("weight");
+        float* weight_data      = reinterpret_cast<float*>(weight.data.data());
+        const size_t kernel_size =
+            weight.data.size() / sizeof(float) / channels;
+
+        std::vector<float> bias(channels, 0.0f);
+        if (use_bias) {
+            const float* conv_bias = GetFloatAttr(conv, "bias");
+            bias.assign(conv_bias, conv_bias + channels);
+        }
+
+        for (int c = 0; c < channels; ++c) {
+            float scale = 1.0f / std::sqrt(var[c] + eps);
+            float shift = -mean[c] * scale;
+            if (use_affine) {
+                scale *= gamma[c];
+                shift = shift * gamma[c] + beta[c];
+            }
+
+            float* kernel = weight_data + c * kernel_size;
+            for (size_t k = 0; k < kernel_size; ++k) {
+                kernel[k] *= scale;
+            }
+
+            bias[c] = bias[c] * scale + shift;
+        }
+
+        conv->params["bias"] = true;
+        conv->attrs["bias"]  = pnnx::Attribute({channels}, bias);
+
+        // conv writes the batch norm output directly
+        pnnx::Operand* batch_norm_output = batch_norm->outputs[0];
+        batch_norm_output->producer      = conv;
+        conv->outputs[0]                 = batch_norm_output;
+
+        RemoveOperator(graph, batch_norm);
+        RemoveOperand(graph, conv_output);
+
+        --i;
+        ++num_fused;
+    }
+
+    LOG(INFO) << "fuse Conv2d BatchNorm2d [" << num_fused << "]";
+
+    return Status::kSuccess;
+}
+
+Status FuseConv2dActivation(pnnx::Graph* graph) {
+    int num_fused = 0;
+
+    // graph->ops changes in loop
+    for (size_t i = 0; i < graph->ops.size(); ++i) {
+        pnnx::Operator* activation = graph->ops[i];
+
+        ActivationType activation_type = ActivationType::kNone;
+        if (!ParseActivationType(activation->type, activation_type) ||
+            1 != activation->inputs.size() || 1 != activation->outputs.size()) {
+            continue;
+        }
+
+        pnnx::Operand* conv_output = activation->inputs[0];
+        pnnx::Operator* conv       = conv_output->producer;
+        if (nullptr == conv || "nn.Conv2d" != conv->type ||
+            1 != conv->outputs.size() || 1 != conv_output->consumers.size()) {
+            continue;
+        }
+
+        // activation of a fused residual add comes after the add
+        const std::string param_name =
+            (2 == conv->inputs.size()) ? "residual_activation" : "activation";
+        if (conv->params.count(param_name) > 0) {
+            continue;
+        }
+
+        conv->params[param_name] = activation->type;
+
+        // conv writes the activation output directly
+        pnnx::Operand* activation_output = activation->outputs[0];
+        activation_output->producer      = conv;
+        conv->outputs[0]                 = activation_output;
+
+        RemoveOperator(graph, activation);
+        RemoveOperand(graph, conv_output);
+
+        --i;
+        ++num_fused;
+    }
+
+    LOG(INFO) << "fuse Conv2d activation [" << num_fused << "]";
+
+    return Status::kSuccess;
+}
+
+Status FuseConv2dResidual(pnnx::Graph* graph) {
+    int num_fused = 0;
+
+    // graph->ops changes in loop
+    for (size_t i = 0; i < graph->ops.size(); ++i) {
+        pnnx::Operator* add = graph->ops[i];
+        if ("BinaryOp" != add->type || !CheckParam(add, "0", 2) ||
+            0 != add->params.at("0").i || 2 != add->inputs.size() ||
+            1 != add->outputs.size()) {
+            continue;
+        }
+
+        pnnx::Operand* add_output = add->outputs[0];
+
+        // either side may be the conv, the other one is the residual
+        pnnx::Operator* conv    = nullptr;
+        pnnx::Operand* residual = nullptr;
+        for (int k = 0; k < 2; ++k) {
+            pnnx::Operand* conv_output = add->inputs[k];
+            pnnx::Operand* other       = add->inputs[1 - k];
+            pnnx::Operator* producer   = conv_output->producer;
+
+            if (nullptr == producer || "nn.Conv2d" != producer->type ||
+                1 != producer->inputs.size() ||
+                1 != producer->outputs.size() ||
+                1 != conv_output->consumers.size() || conv_output == other) {
+                continue;
+            }
+
+            // no broadcast, residual is read at output positions
+            if (conv_output->shape != add_output->shape ||
+                other->shape != add_output->shape ||
+                conv_output->type != other->type) {
+                continue;
+            }
+
+            conv     = producer;
+            residual = other;
+            break;
+        }
+
+        if (nullptr == conv) {
+            continue;
+        }
+
+        pnnx::Operand* conv_output = conv->outputs[0];
+
+        // conv reads residual in place of the add
+        conv->inputs.push_back(residual);
+        std::replace(residual->consumers.begin(),
+                     residual->consumers.end(),
+                     add,
+                     conv);
+
+        add_output->producer = conv;
+        conv->outputs[0]     = add_output;
+
+        RemoveOperator(graph, add);
+        RemoveOperand(graph, conv_output);
+
+        --i;
+        ++num_fused;
+    }
+
+    LOG(INFO) << "fuse Conv2d residual add [" << num_fused << "]";
+
+    return Status::kSuccess;
+}
+
+}  // namespace SimpleInfer
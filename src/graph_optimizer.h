@@ -0,0 +1,34 @@
+#ifndef SIMPLE_INFER_SRC_GRAPH_OPTIMIZER_H_
+#define SIMPLE_INFER_SRC_GRAPH_OPTIMIZER_H_
+
+#include "pnnx/ir.h"
+#include "types.h"
+
+namespace SimpleInfer {
+
+// load time passes on the pnnx graph, run after expand_expression
+Status OptimizeGraph(pnnx::Graph* graph);
+
+// drop operators whose outputs never reach a pnnx.Output, pnnx.Input is kept
+Status EliminateDeadOperators(pnnx::Graph* graph);
+
+// evaluate operators reading only pnnx.Attribute inputs once, each one becomes
+// a pnnx.Attribute holding its result
+Status FoldConstants(pnnx::Graph* graph);
+
+// fold nn.BatchNorm2d into the weight and bias of the preceding nn.Conv2d
+// when the conv output has no other consumer
+Status FuseConv2dBatchNorm2d(pnnx::Graph* graph);
+
+// attach a following activation to nn.Conv2d as param "activation", applied
+// in the conv epilogue together with the bias. param "residual_activation"
+// when the conv already has a fused residual add
+Status FuseConv2dActivation(pnnx::Graph* graph);
+
+// BinaryOp add of a conv output and a same shape tensor, the tensor becomes
+// the second input of nn.Conv2d and is added in the conv epilogue
+Status FuseConv2dResidual(pnnx::Graph* graph);
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_GRAPH_OPTIMIZER_H_
@@ -1,5 +1,8 @@
 #include "layer.h"
 
+#include "layer/simd/parallel.h"
+#include "layer/simd/reorder.h"
+
 namespace SimpleInfer {
 
 Layer::Layer() {}
@@ -25,13 +28,21 @@ void Layer::SetContext(Context* context) {
     context_ = context;
 }
 
+void Layer::SetEigenThreadPoolDevice(Eigen::ThreadPoolDevice* device) {
+    eigen_threadpool_device_ = device;
+}
+
 void Layer::SetInputNodes(const std::vector<TensorNode*>& input_tensor_nodes) {
     input_tensor_nodes_ = input_tensor_nodes;
+
+    input_tensors_.resize(input_tensor_nodes_.size());
 }
 
 void Layer::SetOutputNodes(
     const std::vector<TensorNode*>& output_tensor_nodes) {
     output_tensor_nodes_ = output_tensor_nodes;
+
+    output_tensors_.resize(output_tensor_nodes_.size());
 }
 
 Status Layer::Deinit() {
@@ -42,6 +53,26 @@ Status Layer::Validate() {
     return Status::kSuccess;
 }
 
+bool Layer::SupportInplace() const {
+    return false;
+}
+
+bool Layer::SupportStridedOutput() const {
+    return false;
+}
+
+bool Layer::IsReshapeOnly() const {
+    return false;
+}
+
+bool Layer::SupportLayout(const Layout layout) const {
+    return (Layout::kNHWC == layout);
+}
+
+bool Layer::PreferLayout(const Layout layout) const {
+    return false;
+}
+
 Status Layer::Forward() {
     LOG(INFO) << "Forward Layer [" << op_->name << "]";
 
@@ -50,28 +81,25 @@ Status Layer::Forward() {
             return Forward(input_tensor_nodes_[0]->tensor,
                            output_tensor_nodes_[0]->tensor);
         } else {
-            std::vector<Tensor> outputs(output_tensor_nodes_.size());
             for (size_t i = 0; i < output_tensor_nodes_.size(); ++i) {
-                outputs[i] = output_tensor_nodes_[i]->tensor;
+                output_tensors_[i] = output_tensor_nodes_[i]->tensor;
             }
 
-            return Forward(input_tensor_nodes_[0]->tensor, outputs);
+            return Forward(input_tensor_nodes_[0]->tensor, output_tensors_);
         }
     } else {
-        std::vector<Tensor> inputs(input_tensor_nodes_.size());
         for (size_t i = 0; i < input_tensor_nodes_.size(); ++i) {
-            inputs[i] = input_tensor_nodes_[i]->tensor;
+            input_tensors_[i] = input_tensor_nodes_[i]->tensor;
         }
 
         if (1 == output_tensor_nodes_.size()) {
-            return Forward(inputs, output_tensor_nodes_[0]->tensor);
+            return Forward(input_tensors_, output_tensor_nodes_[0]->tensor);
         } else {
-            std::vector<Tensor> outputs(output_tensor_nodes_.size());
             for (size_t i = 0; i < output_tensor_nodes_.size(); ++i) {
-                outputs[i] = output_tensor_nodes_[i]->tensor;
+                output_tensors_[i] = output_tensor_nodes_[i]->tensor;
             }
 
-            return Forward(inputs, outputs);
+            return Forward(input_tensors_, output_tensors_);
         }
     }
 
@@ -99,6 +127,28 @@ const pnnx::Operator* Layer::GetOp() {
     return op_;
 }
 
+const std::vector<TensorNode*>& Layer::GetInputNodes() {
+    return input_tensor_nodes_;
+}
+
+const std::vector<TensorNode*>& Layer::GetOutputNodes() {
+    return output_tensor_nodes_;
+}
+
+int64_t Layer::GetFlops() {
+    int64_t flops = 0;
+    for (const TensorNode* tensor_node : output_tensor_nodes_) {
+        int64_t size = 1;
+        for (const int s : tensor_node->tensor.Shape()) {
+            size *= s;
+        }
+
+        flops += size;
+    }
+
+    return flops;
+}
+
 Status Layer::ValidateShape(const int input_size, const int output_size) {
     if (input_size >= 0 && input_size != (int)input_tensor_nodes_.size()) {
         LOG(ERROR) << "ValidateShape fail ["
@@ -118,6 +168,10 @@ Status Layer::ValidateShape(const int input_size, const int output_size) {
 }
 
 Eigen::ThreadPoolDevice* Layer::GetEigenThreadPoolDevice() {
+    if (nullptr != eigen_threadpool_device_) {
+        return eigen_threadpool_device_;
+    }
+
     if (nullptr != context_) {
         return context_->GetEigenThreadPoolDevice();
     }
@@ -125,4 +179,100 @@ Eigen::ThreadPoolDevice* Layer::GetEigenThreadPoolDevice() {
     return Context::GetDefaultEigenThreadPoolDevice();
 }
 
+const KernelOptions& Layer::GetKernelOptions() {
+    if (nullptr != context_ && nullptr != op_) {
+        return context_->GetKernelOptions(op_->name, op_->type);
+    }
+
+    static const KernelOptions default_kernel_options;
+
+    return default_kernel_options;
+}
+
+bool Layer::HasSameBatchAndChannel() const {
+    if (nullptr == op_ || op_->outputs.empty()) {
+        return false;
+    }
+
+    // pnnx shapes are NCHW
+    const std::vector<int>& output_shape = op_->outputs[0]->shape;
+    if (4 != output_shape.size()) {
+        return false;
+    }
+
+    std::vector<const pnnx::Operand*> operands(op_->inputs.begin(),
+                                               op_->inputs.end());
+    operands.insert(operands.end(), op_->outputs.begin(), op_->outputs.end());
+
+    for (const pnnx::Operand* operand : operands) {
+        const std::vector<int>& shape = operand->shape;
+        if (4 != shape.size() || shape[0] != output_shape[0] ||
+            shape[1] != output_shape[1]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Status ReorderLayout(Eigen::ThreadPoolDevice* device,
+                     const Tensor& src,
+                     Tensor& dst,
+                     const int channel) {
+    const std::vector<int>& src_shape = src.Shape();
+    const std::vector<int>& dst_shape = dst.Shape();
+
+    // NHWC is a single block of all channels
+    const int src_block = (Layout::kNHWC == src.GetLayout())
+                              ? channel
+                              : LayoutBlock(src.GetLayout());
+    const int dst_block = (Layout::kNHWC == dst.GetLayout())
+                              ? channel
+                              : LayoutBlock(dst.GetLayout());
+
+    if (!IsSameDataType<float>(src.GetDataType()) ||
+        !IsSameDataType<float>(dst.GetDataType()) || 4 != src_shape.size() ||
+        4 != dst_shape.size() || channel <= 0 || src_block != src_shape[3] ||
+        dst_block != dst_shape[3] || !src.IsContiguous() ||
+        !dst.IsContiguous()) {
+        LOG(ERROR) << "ReorderLayout fail ["
+                   << "unsupport tensor"
+                   << "]";
+        return Status::kUnsupport;
+    }
+
+    const int src_blocks = (channel + src_block - 1) / src_block;
+    const int dst_blocks = (channel + dst_block - 1) / dst_block;
+    const int batch      = src_shape[0] / src_blocks;
+    const int hw         = src_shape[1] * src_shape[2];
+
+    if (batch * src_blocks != src_shape[0] ||
+        batch * dst_blocks != dst_shape[0] || src_shape[1] != dst_shape[1] ||
+        src_shape[2] != dst_shape[2]) {
+        LOG(ERROR) << "ReorderLayout fail ["
+                   << "shape mismatch"
+                   << "]";
+        return Status::kErrorShape;
+    }
+
+    const float* src_data = src.GetEigenTensor<float, 1>().data();
+    float* dst_data       = dst.GetEigenTensor<float, 1>().data();
+
+    Parallel(device,
+             0,
+             (size_t)batch * dst_blocks * hw,
+             [&](size_t thread, size_t begin, size_t end) {
+                 ReorderChannelBlocks(src_data,
+                                      src_block,
+                                      dst_data,
+                                      dst_block,
+                                      hw,
+                                      channel,
+                                      begin,
+                                      end);
+             });
+
+    return Status::kSuccess;
+}
+
 }  // namespace SimpleInfer
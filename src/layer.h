@@ -1,6 +1,7 @@
 #ifndef SIMPLE_INFER_SRC_LAYER_H_
 #define SIMPLE_INFER_SRC_LAYER_H_
 
+#include <cstdint>
 #include <vector>
 
 #include "context.h"
@@ -26,6 +27,10 @@ public:
 
     virtual void SetContext(Context* context);
 
+    // overrides the device of context, e.g. fewer threads for a layer which
+    // runs beside others
+    void SetEigenThreadPoolDevice(Eigen::ThreadPoolDevice* device);
+
     virtual void SetInputNodes(
         const std::vector<TensorNode*>& input_tensor_nodes);
 
@@ -36,6 +41,23 @@ public:
 
     virtual Status Validate();
 
+    // output can share memory with input, elementwise layers only
+    virtual bool SupportInplace() const;
+
+    // output can be a channel view of a concatenated tensor, in-place layers
+    // also read such a view, see Tensor::RowStride
+    virtual bool SupportStridedOutput() const;
+
+    // output is input memory with a new shape, engine may alias them
+    virtual bool IsReshapeOnly() const;
+
+    // rank 4 float inputs and outputs can be stored in layout, NHWC only by
+    // default, see Layout
+    virtual bool SupportLayout(const Layout layout) const;
+
+    // runs faster in a supported layout, worth reorders around it
+    virtual bool PreferLayout(const Layout layout) const;
+
     virtual Status Forward();
 
     virtual Status Forward(const Tensor& input, Tensor& output);
@@ -49,20 +71,112 @@ public:
 
     const pnnx::Operator* GetOp();
 
+    const std::vector<TensorNode*>& GetInputNodes();
+
+    const std::vector<TensorNode*>& GetOutputNodes();
+
+    // floating point operations of one Forward, output size by default
+    virtual int64_t GetFlops();
+
 protected:
     virtual Status ValidateShape(const int input_size, const int output_size);
 
     Eigen::ThreadPoolDevice* GetEigenThreadPoolDevice();
 
+    // kernel preferences from engine options, default without context
+    const KernelOptions& GetKernelOptions();
+
+    // all inputs and outputs are rank 4 with the same batch and channels, so
+    // channel blocks line up and broadcast is over height and width only
+    bool HasSameBatchAndChannel() const;
+
+    // output = func(input) for float tensors, both may be channel views
+    template<typename Func>
+    Status ForwardElementwise(const Tensor& input, Tensor& output, Func func);
+
 protected:
     Context* context_ = nullptr;
 
+    Eigen::ThreadPoolDevice* eigen_threadpool_device_ = nullptr;
+
     const pnnx::Operator* op_ = nullptr;
 
     std::vector<TensorNode*> input_tensor_nodes_;
     std::vector<TensorNode*> output_tensor_nodes_;
+
+    // reused by Forward, refreshed from nodes without reallocation
+    std::vector<Tensor> input_tensors_;
+    std::vector<Tensor> output_tensors_;
 };
 
+// copy a rank 4 float tensor into the layout of dst, both are contiguous and
+// allocated with their stored shapes, channel is the real channel count
+Status ReorderLayout(Eigen::ThreadPoolDevice* device,
+                     const Tensor& src,
+                     Tensor& dst,
+                     const int channel);
+
+// assign to output, which may be a channel view
+template<typename T, int num_indices, typename Expr>
+void AssignEigenTensor(Eigen::ThreadPoolDevice* device,
+                       Tensor& output,
+                       const Expr& expr) {
+    if (output.IsContiguous()) {
+        EigenTensorMap<T, num_indices> output_eigen_tensor =
+            output.GetEigenTensor<T, num_indices>();
+
+        output_eigen_tensor.device(*device) = expr;
+    } else {
+        EigenTensorMap<T, num_indices> output_eigen_tensor =
+            output.GetEigenPaddedTensor<T, num_indices>();
+
+        output_eigen_tensor
+            .slice(EigenDSize<num_indices>(),
+                   ToEigenDSize<num_indices>(output.Shape()))
+            .device(*device) = expr;
+    }
+}
+
+template<typename Func>
+Status Layer::ForwardElementwise(const Tensor& input,
+                                 Tensor& output,
+                                 Func func) {
+    Eigen::ThreadPoolDevice* device = GetEigenThreadPoolDevice();
+    if (nullptr == device) {
+        LOG(ERROR) << "Empty Eigen ThreadPool Device";
+        return Status::kErrorContext;
+    }
+
+    if (input.IsContiguous()) {
+        const EigenTensorMap<float, 1> input_eigen_tensor =
+            input.GetEigenTensor<float, 1>();
+
+        if (output.IsContiguous()) {
+            EigenTensorMap<float, 1> output_eigen_tensor =
+                output.GetEigenTensor<float, 1>();
+
+            output_eigen_tensor.device(*device) = func(input_eigen_tensor);
+        } else {
+            AssignEigenTensor<float, 2>(
+                device,
+                output,
+                func(input_eigen_tensor.reshape(
+                    ToEigenDSize<2>(input.Shape()))));
+        }
+    } else {
+        const EigenTensorMap<float, 2> input_eigen_tensor =
+            input.GetEigenPaddedTensor<float, 2>();
+
+        const auto input_view = input_eigen_tensor.slice(
+            EigenDSize<2>(),
+            ToEigenDSize<2>(input.Shape()));
+
+        AssignEigenTensor<float, 2>(device, output, func(input_view));
+    }
+
+    return Status::kSuccess;
+}
+
 // get eigen threadpool device
 #define GET_EIGEN_THREADPOOL_DEVICE(device)                       \
     Eigen::ThreadPoolDevice* device = GetEigenThreadPoolDevice(); \
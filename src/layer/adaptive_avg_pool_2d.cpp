@@ -51,6 +51,11 @@ Status AdaptiveAvgPool2d::Validate() {
     return Status::kSuccess;
 }
 
+bool AdaptiveAvgPool2d::SupportLayout(const Layout) const {
+    // per channel mean over height and width
+    return true;
+}
+
 Status AdaptiveAvgPool2d::Forward(const Tensor& input, Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
@@ -49,6 +49,14 @@ Status BinaryOp::Validate() {
     return Status::kSuccess;
 }
 
+bool BinaryOp::SupportStridedOutput() const {
+    return true;
+}
+
+bool BinaryOp::SupportLayout(const Layout layout) const {
+    return (Layout::kNHWC == layout || HasSameBatchAndChannel());
+}
+
 Status BinaryOp::Forward(const std::vector<Tensor>& inputs, Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
@@ -56,8 +64,6 @@ Status BinaryOp::Forward(const std::vector<Tensor>& inputs, Tensor& output) {
         inputs[0].GetEigenTensor<float, 4>();
     const EigenTensorMap<float, 4> input1_eigen_tensor =
         inputs[1].GetEigenTensor<float, 4>();
-    EigenTensorMap<float, 4> output_eigen_tensor =
-        output.GetEigenTensor<float, 4>();
 
     const EigenDSize<4> input0_dsize = ToEigenDSize<4>(inputs[0].Shape());
     const EigenDSize<4> input1_dsize = ToEigenDSize<4>(inputs[1].Shape());
@@ -79,10 +85,10 @@ Status BinaryOp::Forward(const std::vector<Tensor>& inputs, Tensor& output) {
 
     switch (binary_op_type_) {
         case BinaryOpType::kAdd:
-            output_eigen_tensor.device(*device) = expr0 + expr1;
+            AssignEigenTensor<float, 4>(device, output, expr0 + expr1);
             break;
         case BinaryOpType::kMul:
-            output_eigen_tensor.device(*device) = expr0 * expr1;
+            AssignEigenTensor<float, 4>(device, output, expr0 * expr1);
             break;
         default:
             LOG(ERROR) << "unsupport BinaryOp type [" << (int)binary_op_type_
@@ -16,6 +16,10 @@ public:
 
     virtual Status Validate() override;
 
+    virtual bool SupportStridedOutput() const override;
+
+    virtual bool SupportLayout(const Layout layout) const override;
+
     virtual Status Forward(const std::vector<Tensor>& inputs,
                            Tensor& output) override;
 
@@ -17,6 +17,11 @@ Status Cat::Init(const pnnx::Operator* op) {
     CHECK_BOOL(CheckParam(op, "dim", 2));
     dim_ = op->params.at("dim").i;
 
+    // negative dim counts from the last one
+    if (dim_ < 0 && !op->outputs.empty()) {
+        dim_ += (int)op->outputs[0]->shape.size();
+    }
+
     return Status::kSuccess;
 }
 
@@ -92,9 +97,19 @@ Status Cat::Forward(const std::vector<Tensor>& inputs, Tensor& output) {
 
     int offset = 0;
     for (int i = 0; i < input_nums; ++i) {
+        EigenDSize<4> input_dims = ToEigenDSize<4>(inputs[i].Shape());
+
+        // producer wrote into output already, nothing to copy
+        if (3 == dim && !inputs[i].IsContiguous() &&
+            inputs[i].RowStride() == output.RowStride() &&
+            inputs[i].GetEigenPaddedTensor<float, 4>().data() ==
+                output_eigen_tensor.data() + offset) {
+            offset += input_dims[dim];
+            continue;
+        }
+
         auto input_i = inputs[i].GetEigenTensor<float, 4>();
 
-        EigenDSize<4> input_dims = input_i.dimensions();
         EigenDSize<4> output_offset(0, 0, 0, 0);
         output_offset[dim] = offset;
 
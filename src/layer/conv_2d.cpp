@@ -1,6 +1,8 @@
 #include "conv_2d.h"
 
-#include "simd/binary.h"
+#include <algorithm>
+
+#include "simd/depthwise.h"
 #include "simd/gemm.h"
 #include "simd/parallel.h"
 #include "simd/winograd_helper.h"
@@ -9,6 +11,29 @@ namespace SimpleInfer {
 
 DEFINE_LAYER_REGISTRY(Conv2d);
 
+// epilogue on each finished output block of the contraction. output is row
+// major, so the col major block seen here has output channels as rows and one
+// contiguous pixel per column.
+struct Conv2dOutputKernel {
+    Epilogue epilogue;
+
+    template<typename Index, typename Scalar>
+    EIGEN_ALWAYS_INLINE void operator()(
+        const Eigen::internal::blas_data_mapper<Scalar, Index, Eigen::ColMajor>&
+            output_mapper,
+        const Eigen::TensorContractionParams& params,
+        Index i,
+        Index j,
+        Index num_rows,
+        Index num_cols) const {
+        EpilogueNHWC(epilogue.Offset(j, i),
+                     num_cols,
+                     num_rows,
+                     &output_mapper(0, 0),
+                     output_mapper.stride());
+    }
+};
+
 Conv2d::Conv2d() {}
 
 Conv2d::~Conv2d() {}
@@ -19,6 +44,15 @@ Status Conv2d::Init(const pnnx::Operator* op) {
         return ret;
     }
 
+    // residual fused by graph optimizer
+    use_residual_ = (2 == op->inputs.size());
+
+    // pnnx shapes are NCHW
+    if (1 == op->outputs.size() && 4 == op->outputs[0]->shape.size()) {
+        output_height_ = (std::max)(op->outputs[0]->shape[2], 0);
+        output_width_  = (std::max)(op->outputs[0]->shape[3], 0);
+    }
+
     return Init(op->params, op->attrs);
 }
 
@@ -69,10 +103,25 @@ Status Conv2d::Init(const std::map<std::string, pnnx::Parameter>& params,
     CHECK_BOOL(CheckParam(params, "out_channels", 2));
     out_channels_ = params.at("out_channels").i;
 
+    if (params.count("activation") > 0) {
+        CHECK_BOOL(CheckParam(params, "activation", 4));
+        CHECK_BOOL(ParseActivationType(params.at("activation").s, activation_));
+    }
+
+    if (params.count("residual_activation") > 0) {
+        CHECK_BOOL(CheckParam(params, "residual_activation", 4));
+        CHECK_BOOL(ParseActivationType(params.at("residual_activation").s,
+                                       residual_activation_));
+    }
+
     CHECK_STATUS(InitWeightAndBias(params, attrs));
 
     CHECK_STATUS(InitWinograd());
 
+    CHECK_STATUS(InitPointwise());
+
+    CHECK_STATUS(InitDepthwise());
+
     return Status::kSuccess;
 }
 
@@ -85,7 +134,7 @@ Status Conv2d::Validate() {
     }
 
     {
-        Status ret = ValidateShape(1, 1);
+        Status ret = ValidateShape(use_residual_ ? 2 : 1, 1);
         if (Status::kSuccess != ret) {
             return ret;
         }
@@ -100,21 +149,66 @@ Status Conv2d::Validate() {
         return Status::kUnsupport;
     }
 
+    if (use_residual_) {
+        const Tensor& residual = input_tensor_nodes_[1]->tensor;
+        const Tensor& output   = output_tensor_nodes_[0]->tensor;
+
+        if (!IsSameDataType<float>(residual.GetDataType()) ||
+            !IsSameShape(residual.Shape(), output.Shape())) {
+            LOG(ERROR) << "Conv2d::Validate fail ["
+                       << "residual must be float with output shape"
+                       << "]";
+            return Status::kUnsupport;
+        }
+    }
+
     // TODO: check shape
 
     return Status::kSuccess;
 }
 
-Status Conv2d::Forward(const Tensor& input, Tensor& output) {
-    if (use_winograd_) {
-        return ForwardWinograd23(input, output);
+bool Conv2d::SupportStridedOutput() const {
+    return true;
+}
+
+bool Conv2d::SupportLayout(const Layout layout) const {
+    if (Layout::kNHWC == layout) {
+        return true;
     }
 
-    if (1 == groups_) {
-        return ForwardIm2Col(input, output);
+    // winograd transforms gather and scatter whole channel blocks
+    const int block = LayoutBlock(layout);
+
+    return (use_winograd_ && block > 0 && 0 == in_channels_ % block &&
+            0 == out_channels_ % block);
+}
+
+bool Conv2d::PreferLayout(const Layout layout) const {
+    // channel blocks are gathered straight into the winograd buffers
+    return (Layout::kNHWC != layout && SupportLayout(layout));
+}
+
+int64_t Conv2d::GetFlops() {
+    // multiply and add per kernel element
+    const int64_t kernel_size =
+        (int64_t)in_channels_ / groups_ * kernel_h_ * kernel_w_;
+
+    return 2 * Layer::GetFlops() * kernel_size;
+}
+
+Status Conv2d::Forward(const Tensor& input, Tensor& output) {
+    return Forward(input, CreateEpilogue(nullptr), output);
+}
+
+Status Conv2d::Forward(const std::vector<Tensor>& inputs, Tensor& output) {
+    if (2 != inputs.size()) {
+        LOG(ERROR) << "Conv2d::Forward fail ["
+                   << "need input and residual"
+                   << "]";
+        return Status::kErrorShape;
     }
 
-    return ForwardIm2ColWithGroup(input, output);
+    return Forward(inputs[0], CreateEpilogue(&inputs[1]), output);
 }
 
 Status Conv2d::InitWeightAndBias(
@@ -180,31 +274,182 @@ Status Conv2d::InitWeightAndBias(
 }
 
 Status Conv2d::InitWinograd() {
+    if (!GetKernelOptions().use_winograd) {
+        return Status::kSuccess;
+    }
+
+    // tiny gemms per group lose to the transforms
+    const bool support_groups = (in_channels_ / groups_ >= 8 &&
+                                 out_channels_ / groups_ >= 8);
+
     if (3 == kernel_h_ && 3 == kernel_w_ && 1 == stride_h_ && 1 == stride_w_ &&
-        1 == dilation_h_ && 1 == dilation_w_ && 1 == groups_ &&
-        padding_t_ == padding_b_ && padding_t_ == padding_l_ &&
-        padding_t_ == padding_r_ && (0 == padding_t_ || 1 == padding_t_)) {
-        // convert weights
-        int oc_up4               = (out_channels_ + 3) / 4 * 4;
-        int weight_winograd_size = 16 * in_channels_ * oc_up4;
+        1 == dilation_h_ && 1 == dilation_w_ &&
+        (1 == groups_ || support_groups) && padding_t_ >= 0 &&
+        padding_b_ >= 0 && padding_l_ >= 0 && padding_r_ >= 0) {
+        return InitWinograd(SelectWinogradTile());
+    }
+
+    return Status::kSuccess;
+}
+
+Status Conv2d::InitWinograd(const int tile) {
+    const bool support_tile4 = (in_channels_ >= 4 && out_channels_ >= 4);
+    if (!(2 == tile || (4 == tile && support_tile4))) {
+        LOG(ERROR) << "Conv2d::InitWinograd fail ["
+                   << "unsupport tile " << tile << "]";
+        return Status::kUnsupport;
+    }
+
+    // convert weights of each group, HWIO with I of one group
+    const int in_channels_group  = in_channels_ / groups_;
+    const int out_channels_group = out_channels_ / groups_;
+
+    int oc_up4               = (out_channels_group + 3) / 4 * 4;
+    int weight_winograd_size = (tile + 2) * (tile + 2) * in_channels_group *
+                               oc_up4;
+
+    weight_winograd_.resize(weight_winograd_size * groups_, 0.0f);
+
+    std::vector<float> weight_group(9 * in_channels_group *
+                                    out_channels_group);
+
+    for (int g = 0; g < groups_; ++g) {
+        const float* src = (const float*)weight_.data();
+        float* dst       = weight_winograd_.data() + g * weight_winograd_size;
+
+        for (int k = 0; k < 9 * in_channels_group; ++k) {
+            std::copy(src + k * out_channels_ + g * out_channels_group,
+                      src + k * out_channels_ + (g + 1) * out_channels_group,
+                      weight_group.data() + k * out_channels_group);
+        }
+
+        if (4 == tile) {
+            Conv3x3s1Winograd43TransformKernelPack4(weight_group.data(),
+                                                    in_channels_group,
+                                                    out_channels_group,
+                                                    dst);
+        } else {
+            Conv3x3s1Winograd23TransformKernelPack4(weight_group.data(),
+                                                    in_channels_group,
+                                                    out_channels_group,
+                                                    dst);
+        }
+    }
+
+    winograd_tile_ = tile;
+    use_winograd_  = true;
+
+    return Status::kSuccess;
+}
+
+int Conv2d::SelectWinogradTile() const {
+    // the 6x6 transforms work on whole channel vectors
+    if (in_channels_ < 4 || out_channels_ < 4) {
+        return 2;
+    }
+
+    if (output_height_ <= 0 || output_width_ <= 0) {
+        return 4;
+    }
+
+    // transforms dominate below one whole 4x4 tile
+    if (output_height_ < 4 || output_width_ < 4) {
+        return 2;
+    }
 
-        weight_winograd_.resize(weight_winograd_size, 0.0f);
+    // multiplies in the tile gemms, 4x4 tiles waste more on a ragged border
+    const int64_t tile2_cost = (int64_t)16 * ((output_height_ + 1) / 2) *
+                               ((output_width_ + 1) / 2);
+    const int64_t tile4_cost = (int64_t)36 * ((output_height_ + 3) / 4) *
+                               ((output_width_ + 3) / 4);
 
-        float* src = (float*)weight_.data();
-        float* dst = weight_winograd_.data();
+    return (tile4_cost < tile2_cost ? 4 : 2);
+}
+
+Status Conv2d::InitPointwise() {
+    if (!(1 == kernel_h_ && 1 == kernel_w_ && 1 == stride_h_ &&
+          1 == stride_w_ && 1 == groups_ && 0 == padding_t_ &&
+          0 == padding_b_ && 0 == padding_l_ && 0 == padding_r_)) {
+        return Status::kSuccess;
+    }
 
-        Conv3x3s1Winograd23TransformKernelPack4(src,
-                                                in_channels_,
-                                                out_channels_,
-                                                dst);
+    // HWIO of a 1x1 kernel is already the [ic, oc] matrix
+    const int oc_up4 = (out_channels_ + 3) / 4 * 4;
 
-        use_winograd_ = true;
+    weight_pointwise_.resize(oc_up4 * in_channels_, 0.0f);
+
+    const float* src = (const float*)weight_.data();
+    float* dst       = weight_pointwise_.data();
+
+    for (int j = 0; j < out_channels_; ++j) {
+        for (int i = 0; i < in_channels_; ++i) {
+            dst[(j / 4 * in_channels_ + i) * 4 + j % 4] =
+                src[i * out_channels_ + j];
+        }
     }
 
+    use_pointwise_ = true;
+
     return Status::kSuccess;
 }
 
-Status Conv2d::ForwardIm2Col(const Tensor& input, Tensor& output) {
+Status Conv2d::InitDepthwise() {
+    if (!(in_channels_ == groups_ && out_channels_ == groups_ &&
+          kernel_h_ == kernel_w_ && stride_h_ == stride_w_ &&
+          1 == dilation_h_ && 1 == dilation_w_ &&
+          DepthwiseConv2dSupported(kernel_h_, stride_h_))) {
+        return Status::kSuccess;
+    }
+
+    use_depthwise_ = true;
+
+    return Status::kSuccess;
+}
+
+Epilogue Conv2d::CreateEpilogue(const Tensor* residual) const {
+    Epilogue epilogue;
+    epilogue.activation = activation_;
+
+    if (use_bias_) {
+        epilogue.bias = reinterpret_cast<const float*>(bias_.data());
+    }
+
+    if (nullptr != residual) {
+        // residual may be a channel view
+        epilogue.residual = residual->GetEigenPaddedTensor<float, 4>().data();
+
+        epilogue.residual_ldc        = residual->RowStride();
+        epilogue.residual_activation = residual_activation_;
+    }
+
+    return epilogue;
+}
+
+Status Conv2d::Forward(const Tensor& input,
+                       const Epilogue& epilogue,
+                       Tensor& output) {
+    if (use_winograd_) {
+        return ForwardWinograd(input, epilogue, output);
+    }
+
+    if (use_pointwise_) {
+        return ForwardPointwise(input, epilogue, output);
+    }
+
+    if (use_depthwise_) {
+        return ForwardDepthwise(input, epilogue, output);
+    }
+
+    if (1 == groups_) {
+        return ForwardIm2Col(input, epilogue, output);
+    }
+
+    return ForwardIm2ColWithGroup(input, epilogue, output);
+}
+
+Status Conv2d::ForwardIm2Col(const Tensor& input,
+                             const Epilogue& epilogue,
+                             Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
     const std::vector<int>& input_shape  = input.Shape();
@@ -227,9 +472,6 @@ Status Conv2d::ForwardIm2Col(const Tensor& input, Tensor& output) {
         reinterpret_cast<float*>(weight_.data()),
         weight_shape_);
 
-    EigenTensorMap<float, 4> output_eigen_tensor =
-        output.GetEigenTensor<float, 4>();
-
     // reshape
     const int input_matrix_rows  = input_batch * output_height * output_width;
     const int input_matrix_cols  = kernel_h_ * kernel_w_ * input_channel;
@@ -245,6 +487,9 @@ Status Conv2d::ForwardIm2Col(const Tensor& input, Tensor& output) {
                                      output_width,
                                      output_channel);
 
+    Conv2dOutputKernel output_kernel;
+    output_kernel.epilogue = epilogue;
+
     auto expr = input_eigen_tensor
                     .extract_image_patches(kernel_w_,
                                            kernel_h_,
@@ -260,29 +505,135 @@ Status Conv2d::ForwardIm2Col(const Tensor& input, Tensor& output) {
                                            padding_r_,
                                            static_cast<float>(0))
                     .reshape(pre_contract_dims)
-                    .contract(kernel_tensor.reshape(kernel_dims), contract_dims)
+                    .contract(kernel_tensor.reshape(kernel_dims),
+                              contract_dims,
+                              output_kernel)
                     .reshape(post_contract_dims);
 
-    if (use_bias_) {
-        const EigenTensorMap<float, 1> bias(
-            reinterpret_cast<float*>(bias_.data()),
-            bias_shape_);
+    AssignEigenTensor<float, 4>(device, output, expr);
+
+    return Status::kSuccess;
+}
 
-        output_eigen_tensor.device(*device) =
-            expr + bias.reshape(EigenDSize<4>(1, 1, 1, bias_shape_[0]))
-                       .broadcast(EigenDSize<4>(output_batch,
-                                                output_height,
-                                                output_width,
-                                                1));
+Status Conv2d::ForwardPointwise(const Tensor& input,
+                                const Epilogue& epilogue,
+                                Tensor& output) {
+    GET_EIGEN_THREADPOOL_DEVICE(device);
 
-    } else {
-        output_eigen_tensor.device(*device) = expr;
+    const std::vector<int>& input_shape  = input.Shape();
+    const std::vector<int>& output_shape = output.Shape();
+
+    if (in_channels_ != input_shape[3] || out_channels_ != output_shape[3] ||
+        input_shape[0] * input_shape[1] * input_shape[2] !=
+            output_shape[0] * output_shape[1] * output_shape[2]) {
+        LOG(ERROR) << "Conv2d::ForwardPointwise fail ["
+                   << "unsupport input/output shape"
+                   << "]";
+        return Status::kErrorShape;
+    }
+
+    // both may be channel views
+    const int M = input_shape[0] * input_shape[1] * input_shape[2];
+    const int N = out_channels_;
+    const int K = in_channels_;
+
+    const int lda = input.RowStride();
+    const int ldc = output.RowStride();
+
+    const float* src = input.GetEigenPaddedTensor<float, 4>().data();
+    float* dst       = output.GetEigenPaddedTensor<float, 4>().data();
+
+    // rows of each thread get their epilogue while still in cache
+    SimpleInfer::Parallel(
+        device,
+        0,
+        M,
+        [&](size_t thread, size_t begin, size_t end) {
+            GemmPack4F32(end - begin,
+                         N,
+                         K,
+                         src + begin * lda,
+                         lda,
+                         weight_pointwise_.data(),
+                         dst + begin * ldc,
+                         ldc);
+
+            EpilogueNHWC(epilogue.Offset(begin, 0),
+                         end - begin,
+                         N,
+                         dst + begin * ldc,
+                         ldc);
+        },
+        4);
+
+    return Status::kSuccess;
+}
+
+Status Conv2d::ForwardDepthwise(const Tensor& input,
+                                const Epilogue& epilogue,
+                                Tensor& output) {
+    GET_EIGEN_THREADPOOL_DEVICE(device);
+
+    const std::vector<int>& input_shape  = input.Shape();
+    const std::vector<int>& output_shape = output.Shape();
+
+    const int batch         = input_shape[0];
+    const int input_height  = input_shape[1];
+    const int input_width   = input_shape[2];
+    const int output_height = output_shape[1];
+    const int output_width  = output_shape[2];
+
+    // the kernel trusts oh and ow for the bottom and right padding
+    const int expect_height =
+        (input_height + padding_t_ + padding_b_ - kernel_h_) / stride_h_ + 1;
+    const int expect_width =
+        (input_width + padding_l_ + padding_r_ - kernel_w_) / stride_w_ + 1;
+
+    if (in_channels_ != input_shape[3] || out_channels_ != output_shape[3] ||
+        batch != output_shape[0] || expect_height != output_height ||
+        expect_width != output_width) {
+        LOG(ERROR) << "Conv2d::ForwardDepthwise fail ["
+                   << "unsupport input/output shape"
+                   << "]";
+        return Status::kErrorShape;
     }
 
+    const float* src    = input.GetEigenPaddedTensor<float, 4>().data();
+    const float* weight = reinterpret_cast<const float*>(weight_.data());
+    float* dst          = output.GetEigenPaddedTensor<float, 4>().data();
+
+    const size_t lda = input.RowStride();
+    const size_t ldc = output.RowStride();
+
+    SimpleInfer::Parallel(device,
+                          0,
+                          batch * output_height,
+                          [&](size_t thread, size_t begin, size_t end) {
+                              DepthwiseConv2dNHWC(src,
+                                                  input_height,
+                                                  input_width,
+                                                  in_channels_,
+                                                  lda,
+                                                  weight,
+                                                  kernel_h_,
+                                                  stride_h_,
+                                                  padding_t_,
+                                                  padding_l_,
+                                                  dst,
+                                                  output_height,
+                                                  output_width,
+                                                  ldc,
+                                                  epilogue,
+                                                  begin,
+                                                  end);
+                          });
+
     return Status::kSuccess;
 }
 
-Status Conv2d::ForwardIm2ColWithGroup(const Tensor& input, Tensor& output) {
+Status Conv2d::ForwardIm2ColWithGroup(const Tensor& input,
+                                      const Epilogue& epilogue,
+                                      Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
     const std::vector<int>& input_shape  = input.Shape();
@@ -305,8 +656,9 @@ Status Conv2d::ForwardIm2ColWithGroup(const Tensor& input, Tensor& output) {
         reinterpret_cast<float*>(weight_.data()),
         weight_shape_);
 
+    // channel view of output is handled by slices below
     EigenTensorMap<float, 4> output_eigen_tensor =
-        output.GetEigenTensor<float, 4>();
+        output.GetEigenPaddedTensor<float, 4>();
 
     // reshape
     const int input_channel_group  = input_channel / groups_;
@@ -339,6 +691,9 @@ Status Conv2d::ForwardIm2ColWithGroup(const Tensor& input, Tensor& output) {
         EigenDSize<4> kernel_start_index(0, 0, 0, i * output_channel_group);
         EigenDSize<4> output_start_index(0, 0, 0, i * output_channel_group);
 
+        Conv2dOutputKernel output_kernel;
+        output_kernel.epilogue = epilogue.Offset(0, i * output_channel_group);
+
         output_eigen_tensor.slice(output_start_index, output_group_dims)
             .device(*device) =
             input_eigen_tensor.slice(input_start_index, input_group_dims)
@@ -359,75 +714,103 @@ Status Conv2d::ForwardIm2ColWithGroup(const Tensor& input, Tensor& output) {
                 .contract(
                     kernel_tensor.slice(kernel_start_index, kernel_group_dims)
                         .reshape(kernel_dims),
-                    contract_dims)
+                    contract_dims,
+                    output_kernel)
                 .reshape(output_group_dims);
     }
 
-    if (use_bias_) {
-        const EigenTensorMap<float, 1> bias(
-            reinterpret_cast<float*>(bias_.data()),
-            bias_shape_);
-
-        output_eigen_tensor.device(*device) +=
-            bias.reshape(EigenDSize<4>(1, 1, 1, bias_shape_[0]))
-                .broadcast(EigenDSize<4>(output_batch,
-                                         output_height,
-                                         output_width,
-                                         1));
-    }
-
     return Status::kSuccess;
 }
 
-Status Conv2d::ForwardWinograd23(const Tensor& input, Tensor& output) {
+Status Conv2d::ForwardWinograd(const Tensor& input,
+                               const Epilogue& epilogue,
+                               Tensor& output) {
+    GET_EIGEN_THREADPOOL_DEVICE(device);
+
     const std::vector<int>& input_shape  = input.Shape();
     const std::vector<int>& output_shape = output.Shape();
 
-    const int input_batch   = input_shape[0];
+    // stored shapes of a blocked layout hold channel blocks as batches
     const int input_height  = input_shape[1];
     const int input_width   = input_shape[2];
-    const int input_channel = input_shape[3];
+    const int input_channel = in_channels_;
 
-    const int output_batch   = output_shape[0];
     const int output_height  = output_shape[1];
     const int output_width   = output_shape[2];
-    const int output_channel = output_shape[3];
+    const int output_channel = out_channels_;
+
+    // NHWC is a single block of all channels
+    const int input_block = (Layout::kNHWC == input.GetLayout())
+                                ? input_channel
+                                : LayoutBlock(input.GetLayout());
+    const int output_block = (Layout::kNHWC == output.GetLayout())
+                                 ? output_channel
+                                 : LayoutBlock(output.GetLayout());
+
+    const int input_blocks  = input_channel / input_block;
+    const int output_blocks = output_channel / output_block;
+
+    if (input_block != input_shape[3] || output_block != output_shape[3] ||
+        0 != input_channel % input_block ||
+        0 != output_channel % output_block ||
+        input_shape[0] / input_blocks != output_shape[0] / output_blocks) {
+        LOG(ERROR) << "Conv2d::ForwardWinograd fail ["
+                   << "unsupport input/output layout"
+                   << "]";
+        return Status::kUnsupport;
+    }
 
     const EigenTensorMap<float, 4> input_eigen_tensor =
         input.GetEigenTensor<float, 4>();
 
     EigenTensorMap<float, 4> output_eigen_tensor =
-        output.GetEigenTensor<float, 4>();
+        output.GetEigenPaddedTensor<float, 4>();
 
-    assert(input_batch == output_batch);
+    // one gemm per element of a (tile + 2) x (tile + 2) input tile
+    const int tile      = winograd_tile_;
+    const int tile_size = (tile + 2) * (tile + 2);
 
-    const int tiles_h = (output_height + 1) / 2;
-    const int tiles_w = (output_width + 1) / 2;
+    const int tiles_h = (output_height + tile - 1) / tile;
+    const int tiles_w = (output_width + tile - 1) / tile;
+
+    // gemms of a group read and write a channel slice of the buffers
+    const int input_channel_group  = input_channel / groups_;
+    const int output_channel_group = output_channel / groups_;
 
-    const int output_channel_up4 = (output_channel + 3) / 4 * 4;
-    const int weight_stride      = input_channel * output_channel_up4;
+    const int output_channel_up4 = (output_channel_group + 3) / 4 * 4;
+    const int weight_stride      = input_channel_group * output_channel_up4;
 
-    const int M = tiles_h * tiles_w;
-    const int N = output_channel;
-    const int K = input_channel;
+    // output may be a channel view
+    const int output_row_stride = output.RowStride();
 
-    const int batch       = input_batch;
-    const int input_size  = input_height * input_width * input_channel;
-    const int output_size = output_height * output_width * output_channel;
+    const int batch       = input_shape[0] / input_blocks;
+    const int input_size  = input_height * input_width * input_block;
+    const int output_size = output_height * output_width * output_row_stride;
     const int output_spatial_size = output_height * output_width;
 
-    const int input_buf_stride  = tiles_h * tiles_w * input_channel;
-    const int output_buf_stride = tiles_h * tiles_w * output_channel;
+    // small images are stacked into one pass, so every phase has enough
+    // tiles to split across threads and the gemms get taller
+    const int tiles       = tiles_h * tiles_w;
+    const int batch_step  = (std::max)(1, (std::min)(batch, 1024 / tiles));
+    const int batch_tiles = batch_step * tiles;
+
+    const int N = output_channel_group;
+    const int K = input_channel_group;
+
+    const int input_buf_stride  = batch_tiles * input_channel;
+    const int output_buf_stride = batch_tiles * output_channel;
     const int output_buf_stride_channel_up4 =
-        tiles_h * tiles_w * output_channel_up4;
+        batch_tiles * output_channel_up4 * groups_;
 
     // buffer
-    if (input_buf_winograd_.size() < 16 * input_buf_stride) {
-        input_buf_winograd_.resize(16 * input_buf_stride, 0.0f);
+    if (input_buf_winograd_.size() < tile_size * input_buf_stride) {
+        input_buf_winograd_.resize(tile_size * input_buf_stride, 0.0f);
     }
 
-    if (output_buf_winograd_.size() < 16 * output_buf_stride_channel_up4) {
-        output_buf_winograd_.resize(16 * output_buf_stride_channel_up4, 0.0f);
+    if (output_buf_winograd_.size() <
+        tile_size * output_buf_stride_channel_up4) {
+        output_buf_winograd_.resize(tile_size * output_buf_stride_channel_up4,
+                                    0.0f);
     }
 
     const float* src  = input_eigen_tensor.data();
@@ -435,50 +818,120 @@ Status Conv2d::ForwardWinograd23(const Tensor& input, Tensor& output) {
     float* weight_buf = weight_winograd_.data();
     float* dst_buf    = output_buf_winograd_.data();
     float* dst        = output_eigen_tensor.data();
-    float* bias       = (float*)bias_.data();
 
-    bool pad = (1 == padding_t_);
+    auto transform_input  = (4 == tile) ? Conv3x3s1Winograd43TransformInput
+                                        : Conv3x3s1Winograd23TransformInput;
+    auto transform_output = (4 == tile) ? Conv3x3s1Winograd43TransformOutput
+                                        : Conv3x3s1Winograd23TransformOutput;
 
-    for (int b = 0; b < batch; ++b) {
-        Conv3x3s1Winograd23TransformInput(src + b * input_size,
-                                          input_height,
-                                          input_width,
-                                          input_channel,
-                                          pad,
-                                          src_buf,
-                                          input_buf_stride);
+    for (int b0 = 0; b0 < batch; b0 += batch_step) {
+        const int images = (std::min)(batch_step, batch - b0);
+        const int M      = images * tiles;
 
+        // tiles of every block are gathered into one buffer of all channels,
+        // ranges of tiles may cross images
         SimpleInfer::Parallel(
+            device,
             0,
-            16,
+            images * tiles,
             [&](size_t thread, size_t begin, size_t end) {
-                for (size_t i = begin; i < end; ++i) {
+                while (begin < end) {
+                    const int b          = (int)begin / tiles;
+                    const int tile_begin = (int)begin % tiles;
+                    const int tile_end =
+                        (std::min)(tiles, tile_begin + (int)(end - begin));
+
+                    for (int cb = 0; cb < input_blocks; ++cb) {
+                        transform_input(
+                            src + ((b0 + b) * input_blocks + cb) * input_size,
+                            input_height,
+                            input_width,
+                            input_block,
+                            padding_t_,
+                            padding_l_,
+                            output_width,
+                            src_buf + b * tiles * input_channel +
+                                cb * input_block,
+                            input_buf_stride,
+                            input_channel,
+                            tile_begin,
+                            tile_end);
+                    }
+
+                    begin += tile_end - tile_begin;
+                }
+            },
+            1);
+
+        SimpleInfer::Parallel(
+            device,
+            0,
+            tile_size * groups_,
+            [&](size_t thread, size_t begin, size_t end) {
+                for (size_t j = begin; j < end; ++j) {
+                    const size_t i = j / groups_;
+                    const size_t g = j % groups_;
+
+                    // weights are transformed group by group
+                    const float* weight =
+                        weight_buf + (g * tile_size + i) * weight_stride;
+
                     GemmPack4F32(M,
                                  N,
                                  K,
-                                 src_buf + i * input_buf_stride,
+                                 src_buf + i * input_buf_stride +
+                                     g * input_channel_group,
                                  input_channel,
-                                 weight_buf + i * weight_stride,
-                                 dst_buf + i * output_buf_stride,
+                                 weight,
+                                 dst_buf + i * output_buf_stride +
+                                     g * output_channel_group,
                                  output_channel);
                 }
             },
-            16,
             1);
 
-        Conv3x3s1Winograd23TransformOutput(dst_buf,
-                                           output_buf_stride,
-                                           dst + b * output_size,
-                                           output_height,
-                                           output_width,
-                                           output_channel);
-
-        if (use_bias_) {
-            AddBiasNHWC(bias,
-                        output_spatial_size,
-                        output_channel,
-                        dst + b * output_size);
-        }
+        SimpleInfer::Parallel(
+            device,
+            0,
+            images * tiles,
+            [&](size_t thread, size_t begin, size_t end) {
+                while (begin < end) {
+                    const int b          = (int)begin / tiles;
+                    const int tile_begin = (int)begin % tiles;
+                    const int tile_end =
+                        (std::min)(tiles, tile_begin + (int)(end - begin));
+
+                    for (int cb = 0; cb < output_blocks; ++cb) {
+                        const int block_index =
+                            (b0 + b) * output_blocks + cb;
+
+                        // residual has the layout of output, bias is per
+                        // channel
+                        Epilogue block_epilogue = epilogue.Offset(
+                            block_index * output_spatial_size,
+                            0);
+                        if (nullptr != block_epilogue.bias) {
+                            block_epilogue.bias += cb * output_block;
+                        }
+
+                        transform_output(dst_buf + b * tiles * output_channel +
+                                             cb * output_block,
+                                         output_buf_stride,
+                                         dst + block_index * output_size,
+                                         output_height,
+                                         output_width,
+                                         output_block,
+                                         output_row_stride,
+                                         block_epilogue,
+                                         output_channel,
+                                         tile_begin,
+                                         tile_end);
+                    }
+
+                    begin += tile_end - tile_begin;
+                }
+            },
+            1);
     }
 
     return Status::kSuccess;
@@ -2,6 +2,7 @@
 #define SIMPLE_INFER_SRC_LAYER_CONV_2D_H_
 
 #include "layer.h"
+#include "simd/activation.h"
 
 namespace SimpleInfer {
 
@@ -20,20 +21,68 @@ public:
 
     virtual Status Validate() override;
 
+    virtual bool SupportStridedOutput() const override;
+
+    // blocked layouts run on the winograd path only
+    virtual bool SupportLayout(const Layout layout) const override;
+
+    virtual bool PreferLayout(const Layout layout) const override;
+
+    virtual int64_t GetFlops() override;
+
     virtual Status Forward(const Tensor& input, Tensor& output) override;
 
+    // inputs[1] is the residual added in the epilogue
+    virtual Status Forward(const std::vector<Tensor>& inputs,
+                           Tensor& output) override;
+
 public:
     Status InitWeightAndBias(
         const std::map<std::string, pnnx::Parameter>& params,
         const std::map<std::string, pnnx::Attribute>& attrs);
 
+    // picks the tile with SelectWinogradTile when eligible
     Status InitWinograd();
 
-    Status ForwardIm2Col(const Tensor& input, Tensor& output);
+    // F(2x2,3x3) or F(4x4,3x3) for tile 2 or 4
+    Status InitWinograd(const int tile);
+
+    int SelectWinogradTile() const;
+
+    // 1x1, stride 1, no padding and one group
+    Status InitPointwise();
+
+    // one filter per channel, see DepthwiseConv2dSupported
+    Status InitDepthwise();
+
+    // bias, activation and residual of this layer, residual may be nullptr
+    Epilogue CreateEpilogue(const Tensor* residual) const;
 
-    Status ForwardIm2ColWithGroup(const Tensor& input, Tensor& output);
+    Status Forward(const Tensor& input,
+                   const Epilogue& epilogue,
+                   Tensor& output);
 
-    Status ForwardWinograd23(const Tensor& input, Tensor& output);
+    Status ForwardIm2Col(const Tensor& input,
+                         const Epilogue& epilogue,
+                         Tensor& output);
+
+    Status ForwardIm2ColWithGroup(const Tensor& input,
+                                  const Epilogue& epilogue,
+                                  Tensor& output);
+
+    Status ForwardWinograd(const Tensor& input,
+                           const Epilogue& epilogue,
+                           Tensor& output);
+
+    // NHWC input is a [n * h * w, ic] matrix, no patches
+    Status ForwardPointwise(const Tensor& input,
+                            const Epilogue& epilogue,
+                            Tensor& output);
+
+    // direct loop over the weight_ taps, rows split across threads
+    Status ForwardDepthwise(const Tensor& input,
+                            const Epilogue& epilogue,
+                            Tensor& output);
 
 public:
     enum class PaddingMode { kZeros = 0, kReplicate, kReflect } padding_mode_;
@@ -51,20 +100,36 @@ public:
     int in_channels_  = 0;
     int out_channels_ = 0;
 
+    // from the op shape, 0 when unknown
+    int output_height_ = 0;
+    int output_width_  = 0;
+
     bool use_bias_ = false;
     EigenDSize<4> weight_shape_;
     std::vector<char> weight_;
     EigenDSize<1> bias_shape_;
     std::vector<char> bias_;
 
-    // winograd
+    // fused by graph optimizer, applied with the bias
+    ActivationType activation_ = ActivationType::kNone;
+
+    // second input added after activation_, then residual_activation_
+    bool use_residual_                  = false;
+    ActivationType residual_activation_ = ActivationType::kNone;
+
+    // winograd, output tile of 2 or 4
     bool use_winograd_ = false;
-    int tiles_h_       = 0;
-    int tiles_w_       = 0;
+    int winograd_tile_ = 2;
 
     std::vector<float> weight_winograd_;
     std::vector<float> input_buf_winograd_;
     std::vector<float> output_buf_winograd_;
+
+    // pointwise, weight packed as [oc/4][ic][4(oc)]
+    bool use_pointwise_ = false;
+    std::vector<float> weight_pointwise_;
+
+    bool use_depthwise_ = false;
 };
 
 }  // namespace SimpleInfer
@@ -0,0 +1,396 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+#include <stack>
+
+#include "simd/parallel.h"
+
+namespace SimpleInfer {
+
+DEFINE_LAYER_REGISTRY(Expression);
+
+// elements of a row evaluated together, temporaries stay in L1
+static const size_t kExpressionBlock = 256;
+
+static const std::map<std::string, ExpressionOpType> kExpressionBinaryOps = {
+    {"add", ExpressionOpType::kAdd},
+    {"sub", ExpressionOpType::kSub},
+    {"mul", ExpressionOpType::kMul},
+    {"div", ExpressionOpType::kDiv},
+    {"maximum", ExpressionOpType::kMaximum},
+    {"minimum", ExpressionOpType::kMinimum},
+};
+
+static const std::map<std::string, ExpressionOpType> kExpressionUnaryOps = {
+    {"neg", ExpressionOpType::kNeg},
+    {"abs", ExpressionOpType::kAbs},
+    {"square", ExpressionOpType::kSquare},
+    {"sqrt", ExpressionOpType::kSqrt},
+    {"rsqrt", ExpressionOpType::kRsqrt},
+    {"reciprocal", ExpressionOpType::kReciprocal},
+    {"exp", ExpressionOpType::kExp},
+};
+
+// std::isdigit is undefined for negative char
+static bool IsDigit(const char c) {
+    return 0 != std::isdigit((unsigned char)c);
+}
+
+static bool ParseLiteral(const std::string& token, float& literal) {
+    std::istringstream iss(token);
+    iss >> std::noskipws >> literal;
+
+    return (iss.eof() && !iss.fail());
+}
+
+static int CountOperations(const std::vector<ExpressionStep>& steps) {
+    int count = 0;
+    for (const ExpressionStep& step : steps) {
+        if (ExpressionOpType::kInput != step.type &&
+            ExpressionOpType::kLiteral != step.type) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+// row of input read at output row, dimensions of size 1 are broadcast
+static size_t BroadcastRow(const std::vector<int>& input_shape,
+                           const std::vector<int>& output_shape,
+                           size_t row) {
+    size_t input_row  = 0;
+    size_t input_rows = 1;
+    for (int i = (int)output_shape.size() - 2; i >= 0; --i) {
+        const size_t index = row % (size_t)output_shape[i];
+        row /= (size_t)output_shape[i];
+
+        if (1 != input_shape[i]) {
+            input_row += index * input_rows;
+        }
+
+        input_rows *= (size_t)input_shape[i];
+    }
+
+    return input_row;
+}
+
+Expression::Expression() {}
+
+Expression::~Expression() {}
+
+Status Expression::Init(const pnnx::Operator* op) {
+    Status ret = Layer::Init(op);
+    if (Status::kSuccess != ret) {
+        return ret;
+    }
+
+    CHECK_BOOL(CheckParam(op, "expr", 4));
+
+    const std::string& expr = op->params.at("expr").s;
+    if (Status::kSuccess != Parse(expr, steps_)) {
+        LOG(ERROR) << "unsupport Expression [" << expr << "]";
+        return Status::kUnsupport;
+    }
+
+    return Status::kSuccess;
+}
+
+Status Expression::Validate() {
+    {
+        Status ret = Layer::Validate();
+        if (Status::kSuccess != ret) {
+            return ret;
+        }
+    }
+
+    {
+        Status ret = ValidateShape(-1, 1);
+        if (Status::kSuccess != ret) {
+            return ret;
+        }
+    }
+
+    const Tensor& output = output_tensor_nodes_[0]->tensor;
+    if (!IsSameDataType<float>(output.GetDataType())) {
+        LOG(ERROR) << "Expression::Validate fail ["
+                   << "unsupport output data type"
+                   << "]";
+        return Status::kUnsupport;
+    }
+
+    for (const ExpressionStep& step : steps_) {
+        if (ExpressionOpType::kInput == step.type &&
+            step.input >= (int)input_tensor_nodes_.size()) {
+            LOG(ERROR) << "Expression::Validate fail ["
+                       << "input @" << step.input << " not exist"
+                       << "]";
+            return Status::kErrorShape;
+        }
+    }
+
+    const std::vector<int>& output_shape = output.Shape();
+    for (const TensorNode* input_tensor_node : input_tensor_nodes_) {
+        const Tensor& input = input_tensor_node->tensor;
+        if (!IsSameDataType<float>(input.GetDataType())) {
+            LOG(ERROR) << "Expression::Validate fail ["
+                       << "unsupport input data type"
+                       << "]";
+            return Status::kUnsupport;
+        }
+
+        const std::vector<int>& input_shape = input.Shape();
+        if (input_shape.size() != output_shape.size()) {
+            LOG(ERROR) << "Expression::Validate fail ["
+                       << "different shape size"
+                       << "]";
+            return Status::kUnsupport;
+        }
+
+        for (size_t i = 0; i < input_shape.size(); ++i) {
+            if (input_shape[i] != output_shape[i] && 1 != input_shape[i]) {
+                LOG(ERROR) << "Expression::Validate fail ["
+                           << "error input/output shape"
+                           << "]";
+                return Status::kErrorShape;
+            }
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+bool Expression::SupportStridedOutput() const {
+    return true;
+}
+
+bool Expression::SupportLayout(const Layout layout) const {
+    return (Layout::kNHWC == layout || HasSameBatchAndChannel());
+}
+
+Status Expression::Forward(const Tensor& input, Tensor& output) {
+    return Forward(std::vector<Tensor>{input}, output);
+}
+
+Status Expression::Forward(const std::vector<Tensor>& inputs, Tensor& output) {
+    GET_EIGEN_THREADPOOL_DEVICE(device);
+
+    const std::vector<int>& shape = output.Shape();
+    const size_t channel          = (size_t)shape.back();
+
+    size_t rows = 1;
+    for (size_t i = 0; i + 1 < shape.size(); ++i) {
+        rows *= (size_t)shape[i];
+    }
+
+    // no broadcast, the whole tensor is one long row
+    bool flat = output.IsContiguous();
+    for (const Tensor& input : inputs) {
+        flat = flat && input.IsContiguous() &&
+               IsSameShape(input.Shape(), shape);
+    }
+
+    const size_t num_rows   = flat ? 1 : rows;
+    const size_t row_size   = flat ? rows * channel : channel;
+    const size_t num_blocks = (row_size + kExpressionBlock - 1) /
+                              kExpressionBlock;
+
+    float* output_data = output.GetEigenPaddedTensor<float, 2>().data();
+
+    std::vector<const float*> input_data;
+    for (const Tensor& input : inputs) {
+        input_data.push_back(input.GetEigenPaddedTensor<float, 2>().data());
+    }
+
+    const size_t num_steps   = steps_.size();
+    const size_t num_threads = (size_t)device->numThreads();
+
+    // Parallel() numbers its blocks below the thread count of device
+    if (scratch_.size() < num_threads * num_steps * kExpressionBlock) {
+        scratch_.resize(num_threads * num_steps * kExpressionBlock);
+        values_.resize(num_threads * num_steps);
+    }
+
+    Parallel(
+        device,
+        0,
+        num_rows * num_blocks,
+        [&](size_t thread, size_t begin, size_t end) {
+            float* scratch = scratch_.data() +
+                             thread * num_steps * kExpressionBlock;
+            const float** values = values_.data() + thread * num_steps;
+
+            // literals are the same for every block
+            for (size_t i = 0; i < num_steps; ++i) {
+                if (ExpressionOpType::kLiteral == steps_[i].type) {
+                    float* slot = scratch + i * kExpressionBlock;
+                    std::fill(slot, slot + kExpressionBlock, steps_[i].literal);
+                    values[i] = slot;
+                }
+            }
+
+            for (size_t u = begin; u < end; ++u) {
+                const size_t row = u / num_blocks;
+                const size_t col = (u % num_blocks) * kExpressionBlock;
+                const size_t n = (std::min)(kExpressionBlock, row_size - col);
+
+                for (size_t i = 0; i < num_steps; ++i) {
+                    if (ExpressionOpType::kInput != steps_[i].type) {
+                        continue;
+                    }
+
+                    const int k         = steps_[i].input;
+                    const Tensor& input = inputs[k];
+
+                    const size_t input_row =
+                        flat ? 0 : BroadcastRow(input.Shape(), shape, row);
+                    const float* data =
+                        input_data[k] + input_row * input.RowStride();
+
+                    if (!flat && 1 == input.Shape().back() && 1 != channel) {
+                        float* slot = scratch + i * kExpressionBlock;
+                        std::fill(slot, slot + n, data[0]);
+                        values[i] = slot;
+                    } else {
+                        values[i] = data + col;
+                    }
+                }
+
+                float* dst = output_data + row * output.RowStride() + col;
+
+                EvaluateExpression(steps_,
+                                   values,
+                                   scratch,
+                                   kExpressionBlock,
+                                   n,
+                                   dst);
+            }
+        });
+
+    return Status::kSuccess;
+}
+
+Status Expression::Parse(const std::string& expr,
+                         std::vector<ExpressionStep>& steps) {
+    // split into tokens, same as expand_expression
+    std::vector<std::string> tokens;
+    {
+        std::string token;
+        for (const char ch : expr) {
+            if ('[' == ch) {
+                return Status::kUnsupport;
+            }
+
+            if ('(' == ch || ')' == ch || ',' == ch || ']' == ch) {
+                if (!token.empty()) {
+                    tokens.push_back(token);
+                    token.clear();
+                }
+            } else {
+                token += ch;
+            }
+        }
+
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+    }
+
+    steps.clear();
+
+    // prefix notation, operands are pushed before their operation
+    std::stack<int> stack;
+    for (int i = (int)tokens.size() - 1; i >= 0; --i) {
+        const std::string& token = tokens[i];
+
+        ExpressionStep step;
+
+        const bool is_binary = (kExpressionBinaryOps.count(token) > 0);
+        const bool is_unary  = (kExpressionUnaryOps.count(token) > 0);
+
+        if (is_binary || is_unary) {
+            const size_t arity = is_binary ? 2 : 1;
+            if (stack.size() < arity) {
+                return Status::kFail;
+            }
+
+            step.type = is_binary ? kExpressionBinaryOps.at(token)
+                                  : kExpressionUnaryOps.at(token);
+
+            step.a = stack.top();
+            stack.pop();
+
+            if (is_binary) {
+                step.b = stack.top();
+                stack.pop();
+            }
+        } else if (token.size() > 1 && '@' == token[0] &&
+                   std::all_of(token.begin() + 1, token.end(), IsDigit)) {
+            step.type  = ExpressionOpType::kInput;
+            step.input = std::stoi(token.substr(1));
+        } else if (ParseLiteral(token, step.literal)) {
+            step.type = ExpressionOpType::kLiteral;
+        } else {
+            return Status::kUnsupport;
+        }
+
+        stack.push((int)steps.size());
+        steps.push_back(step);
+    }
+
+    if (1 != stack.size() || 0 == CountOperations(steps)) {
+        return Status::kFail;
+    }
+
+    return Status::kSuccess;
+}
+
+bool Expression::IsFusible(const pnnx::Operator* op) {
+    if ("pnnx.Expression" != op->type || !CheckParam(op, "expr", 4) ||
+        op->inputs.empty() || 1 != op->outputs.size()) {
+        return false;
+    }
+
+    std::vector<ExpressionStep> steps;
+    if (Status::kSuccess != Parse(op->params.at("expr").s, steps) ||
+        CountOperations(steps) < 2) {
+        return false;
+    }
+
+    const pnnx::Operand* output = op->outputs[0];
+    if (1 != output->type || output->shape.empty()) {
+        return false;
+    }
+
+    for (const int s : output->shape) {
+        if (s <= 0) {
+            return false;
+        }
+    }
+
+    for (const ExpressionStep& step : steps) {
+        if (ExpressionOpType::kInput == step.type &&
+            step.input >= (int)op->inputs.size()) {
+            return false;
+        }
+    }
+
+    for (const pnnx::Operand* input : op->inputs) {
+        if (1 != input->type || input->shape.size() != output->shape.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < input->shape.size(); ++i) {
+            if (input->shape[i] != output->shape[i] && 1 != input->shape[i]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,54 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_EXPRESSION_H_
+#define SIMPLE_INFER_SRC_LAYER_EXPRESSION_H_
+
+#include <string>
+#include <vector>
+
+#include "layer.h"
+#include "simd/expression.h"
+
+namespace SimpleInfer {
+
+// pnnx.Expression evaluated in one pass over the output, operands broadcast
+// along dimensions of size 1
+class Expression : public Layer {
+public:
+    Expression();
+
+    virtual ~Expression() override;
+
+public:
+    virtual Status Init(const pnnx::Operator* op) override;
+
+    virtual Status Validate() override;
+
+    virtual bool SupportStridedOutput() const override;
+
+    virtual bool SupportLayout(const Layout layout) const override;
+
+    virtual Status Forward(const Tensor& input, Tensor& output) override;
+
+    virtual Status Forward(const std::vector<Tensor>& inputs,
+                           Tensor& output) override;
+
+public:
+    // prefix expression of pnnx, e.g. "add(mul(@0,@1),1.0)", no log on fail
+    static Status Parse(const std::string& expr,
+                        std::vector<ExpressionStep>& steps);
+
+    // expand_expression keeps it as one operator, only worth it for two or
+    // more operations
+    static bool IsFusible(const pnnx::Operator* op);
+
+public:
+    std::vector<ExpressionStep> steps_;
+
+protected:
+    // a block per step for each thread of Parallel(), grown by Forward
+    std::vector<float> scratch_;
+    std::vector<const float*> values_;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYER_EXPRESSION_H_
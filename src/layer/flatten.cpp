@@ -4,6 +4,15 @@ namespace SimpleInfer {
 
 DEFINE_LAYER_REGISTRY(Flatten);
 
+// NHWC -> NCHW keeps element order when either side is a single element
+static bool IsSameMemoryOrder(const std::vector<int>& input_shape) {
+    if (4 != input_shape.size()) {
+        return true;
+    }
+
+    return (1 == input_shape[1] * input_shape[2] || 1 == input_shape[3]);
+}
+
 Flatten::Flatten() {}
 
 Flatten::~Flatten() {}
@@ -52,12 +61,28 @@ Status Flatten::Validate() {
     return Status::kSuccess;
 }
 
+bool Flatten::IsReshapeOnly() const {
+    if (input_tensor_nodes_.empty()) {
+        return false;
+    }
+
+    return IsSameMemoryOrder(input_tensor_nodes_[0]->tensor.Shape());
+}
+
 Status Flatten::Forward(const Tensor& input, Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
     const std::vector<int>& input_shape = input.Shape();
     const int input_dims_num            = (int)input_shape.size();
 
+    const float* input_data  = input.GetEigenTensor<float, 1>().data();
+    const float* output_data = output.GetEigenTensor<float, 1>().data();
+
+    // output is a view of input, see EngineImpl::CreateTensorAliases
+    if (input_data == output_data && IsSameMemoryOrder(input_shape)) {
+        return Status::kSuccess;
+    }
+
     int total_size = 1;
     for (int i = 0; i < input_dims_num; ++i) {
         total_size *= input_shape[i];
@@ -68,7 +93,7 @@ Status Flatten::Forward(const Tensor& input, Tensor& output) {
         output.GetEigenTensor<float, 1>();
 
     // TODO: support more
-    if (4 == input_dims_num) {
+    if (4 == input_dims_num && !IsSameMemoryOrder(input_shape)) {
         // NHWC -> NCHW
         EigenDSize<4> input_shuffle(0, 3, 1, 2);
 
@@ -16,6 +16,8 @@ public:
 
     virtual Status Validate() override;
 
+    virtual bool IsReshapeOnly() const override;
+
     virtual Status Forward(const Tensor& input, Tensor& output) override;
 
 public:
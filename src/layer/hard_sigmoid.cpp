@@ -59,22 +59,23 @@ Status HardSigmoid::Validate() {
     return Status::kSuccess;
 }
 
-Status HardSigmoid::Forward(const Tensor& input, Tensor& output) {
-    GET_EIGEN_THREADPOOL_DEVICE(device);
-
-    const EigenTensorMap<float, 1> input_eigen_tensor =
-        input.GetEigenTensor<float, 1>();
-
-    EigenTensorMap<float, 1> output_eigen_tensor =
-        output.GetEigenTensor<float, 1>();
-
-    auto expr0 = input_eigen_tensor * alpha_ + beta_;
+bool HardSigmoid::SupportInplace() const {
+    return true;
+}
 
-    auto expr1 = expr0.clip(0.0f, 1.0f);
+bool HardSigmoid::SupportStridedOutput() const {
+    return true;
+}
 
-    output_eigen_tensor.device(*device) = expr1;
+bool HardSigmoid::SupportLayout(const Layout) const {
+    // elementwise, any layout
+    return true;
+}
 
-    return Status::kSuccess;
+Status HardSigmoid::Forward(const Tensor& input, Tensor& output) {
+    return ForwardElementwise(input, output, [&](const auto& x) {
+        return (x * alpha_ + beta_).clip(0.0f, 1.0f);
+    });
 }
 
 }  // namespace SimpleInfer
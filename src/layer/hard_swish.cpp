@@ -59,24 +59,23 @@ Status HardSwish::Validate() {
     return Status::kSuccess;
 }
 
-Status HardSwish::Forward(const Tensor& input, Tensor& output) {
-    GET_EIGEN_THREADPOOL_DEVICE(device);
-
-    const EigenTensorMap<float, 1> input_eigen_tensor =
-        input.GetEigenTensor<float, 1>();
-
-    EigenTensorMap<float, 1> output_eigen_tensor =
-        output.GetEigenTensor<float, 1>();
-
-    auto expr0 = input_eigen_tensor * alpha_ + beta_;
-
-    auto expr1 = expr0.clip(0.0f, 1.0f);
+bool HardSwish::SupportInplace() const {
+    return true;
+}
 
-    auto expr2 = input_eigen_tensor * expr1;
+bool HardSwish::SupportStridedOutput() const {
+    return true;
+}
 
-    output_eigen_tensor.device(*device) = expr2;
+bool HardSwish::SupportLayout(const Layout) const {
+    // elementwise, any layout
+    return true;
+}
 
-    return Status::kSuccess;
+Status HardSwish::Forward(const Tensor& input, Tensor& output) {
+    return ForwardElementwise(input, output, [&](const auto& x) {
+        return x * (x * alpha_ + beta_).clip(0.0f, 1.0f);
+    });
 }
 
 }  // namespace SimpleInfer
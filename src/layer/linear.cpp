@@ -71,6 +71,11 @@ Status Linear::Validate() {
     return Status::kSuccess;
 }
 
+int64_t Linear::GetFlops() {
+    // multiply and add per input feature
+    return 2 * Layer::GetFlops() * in_features_;
+}
+
 Status Linear::Forward(const Tensor& input, Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
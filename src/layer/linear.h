@@ -16,6 +16,8 @@ public:
 
     virtual Status Validate() override;
 
+    virtual int64_t GetFlops() override;
+
     virtual Status Forward(const Tensor& input, Tensor& output) override;
 
 public:
@@ -74,6 +74,11 @@ Status MaxPool2d::Validate() {
     return Status::kSuccess;
 }
 
+bool MaxPool2d::SupportLayout(const Layout) const {
+    // pools each channel alone, a channel block is like another batch
+    return true;
+}
+
 Status MaxPool2d::Forward(const Tensor& input, Tensor& output) {
     GET_EIGEN_THREADPOOL_DEVICE(device);
 
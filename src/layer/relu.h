@@ -16,6 +16,12 @@ public:
 
     virtual Status Validate() override;
 
+    virtual bool SupportInplace() const override;
+
+    virtual bool SupportStridedOutput() const override;
+
+    virtual bool SupportLayout(const Layout layout) const override;
+
     virtual Status Forward(const Tensor& input, Tensor& output) override;
 };
 
@@ -0,0 +1,61 @@
+#include "reorder.h"
+
+namespace SimpleInfer {
+
+DEFINE_LAYER_REGISTRY(Reorder);
+
+Reorder::Reorder() {}
+
+Reorder::~Reorder() {}
+
+Status Reorder::Init(const pnnx::Operator* op) {
+    Status ret = Layer::Init(op);
+    if (Status::kSuccess != ret) {
+        return ret;
+    }
+
+    // pnnx shape is NCHW
+    CHECK_BOOL(1 == op->inputs.size() && 4 == op->inputs[0]->shape.size());
+    channel_ = op->inputs[0]->shape[1];
+
+    return Status::kSuccess;
+}
+
+Status Reorder::Validate() {
+    {
+        Status ret = Layer::Validate();
+        if (Status::kSuccess != ret) {
+            return ret;
+        }
+    }
+
+    {
+        Status ret = ValidateShape(1, 1);
+        if (Status::kSuccess != ret) {
+            return ret;
+        }
+    }
+
+    if (!(IsSameDataType<float>(input_tensor_nodes_[0]->tensor.GetDataType()) &&
+          IsSameDataType<float>(
+              output_tensor_nodes_[0]->tensor.GetDataType()))) {
+        LOG(ERROR) << "Reorder::Validate fail ["
+                   << "unsupport input/output data type"
+                   << "]";
+        return Status::kUnsupport;
+    }
+
+    return Status::kSuccess;
+}
+
+bool Reorder::SupportLayout(const Layout) const {
+    return true;
+}
+
+Status Reorder::Forward(const Tensor& input, Tensor& output) {
+    GET_EIGEN_THREADPOOL_DEVICE(device);
+
+    return ReorderLayout(device, input, output, channel_);
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,32 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_REORDER_H_
+#define SIMPLE_INFER_SRC_LAYER_REORDER_H_
+
+#include "layer.h"
+
+namespace SimpleInfer {
+
+// inserted by engine between a producer and consumers in different layouts,
+// copies input into the layout of output
+class Reorder : public Layer {
+public:
+    Reorder();
+
+    virtual ~Reorder() override;
+
+public:
+    virtual Status Init(const pnnx::Operator* op) override;
+
+    virtual Status Validate() override;
+
+    virtual bool SupportLayout(const Layout layout) const override;
+
+    virtual Status Forward(const Tensor& input, Tensor& output) override;
+
+public:
+    // real channels, stored shapes of blocked layouts are padded
+    int channel_ = 0;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYER_REORDER_H_
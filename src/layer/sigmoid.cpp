@@ -52,18 +52,23 @@ Status Sigmoid::Validate() {
     return Status::kSuccess;
 }
 
-Status Sigmoid::Forward(const Tensor& input, Tensor& output) {
-    GET_EIGEN_THREADPOOL_DEVICE(device);
-
-    const EigenTensorMap<float, 1> input_eigen_tensor =
-        input.GetEigenTensor<float, 1>();
+bool Sigmoid::SupportInplace() const {
+    return true;
+}
 
-    EigenTensorMap<float, 1> output_eigen_tensor =
-        output.GetEigenTensor<float, 1>();
+bool Sigmoid::SupportStridedOutput() const {
+    return true;
+}
 
-    output_eigen_tensor.device(*device) = input_eigen_tensor.sigmoid();
+bool Sigmoid::SupportLayout(const Layout) const {
+    // elementwise, any layout
+    return true;
+}
 
-    return Status::kSuccess;
+Status Sigmoid::Forward(const Tensor& input, Tensor& output) {
+    return ForwardElementwise(input, output, [](const auto& x) {
+        return x.sigmoid();
+    });
 }
 
 }  // namespace SimpleInfer
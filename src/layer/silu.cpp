@@ -46,19 +46,23 @@ Status SiLU::Validate() {
     return Status::kSuccess;
 }
 
-Status SiLU::Forward(const Tensor& input, Tensor& output) {
-    GET_EIGEN_THREADPOOL_DEVICE(device);
-
-    const EigenTensorMap<float, 1> input_eigen_tensor =
-        input.GetEigenTensor<float, 1>();
+bool SiLU::SupportInplace() const {
+    return true;
+}
 
-    EigenTensorMap<float, 1> output_eigen_tensor =
-        output.GetEigenTensor<float, 1>();
+bool SiLU::SupportStridedOutput() const {
+    return true;
+}
 
-    output_eigen_tensor.device(*device) =
-        input_eigen_tensor / (1.0f + (-input_eigen_tensor).exp());
+bool SiLU::SupportLayout(const Layout) const {
+    // elementwise, any layout
+    return true;
+}
 
-    return Status::kSuccess;
+Status SiLU::Forward(const Tensor& input, Tensor& output) {
+    return ForwardElementwise(input, output, [](const auto& x) {
+        return x / (1.0f + (-x).exp());
+    });
 }
 
 }  // namespace SimpleInfer
@@ -0,0 +1,69 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_SIMD_ACTIVATION_INL_H_
+#define SIMPLE_INFER_SRC_LAYER_SIMD_ACTIVATION_INL_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "activation.h"
+#include "hwy/contrib/math/math-inl.h"
+#include "hwy/highway.h"
+
+namespace hwy {
+namespace HWY_NAMESPACE {
+
+// exp(-x) overflows float above this
+static const float kActivationExpLimit = 88.0f;
+
+template<class D, class V>
+inline V Activation(D d, V x, SimpleInfer::ActivationType activation) {
+    using SimpleInfer::ActivationType;
+
+    switch (activation) {
+        case ActivationType::kReLU:
+            return Max(x, Zero(d));
+        case ActivationType::kSiLU:
+            return Div(x,
+                       Add(Set(d, 1.0f),
+                           Exp(d, Min(Neg(x), Set(d, kActivationExpLimit)))));
+        case ActivationType::kSigmoid:
+            return Div(Set(d, 1.0f),
+                       Add(Set(d, 1.0f),
+                           Exp(d, Min(Neg(x), Set(d, kActivationExpLimit)))));
+        case ActivationType::kHardSwish:
+            return Mul(x,
+                       Min(Max(MulAdd(x, Set(d, 1.0f / 6.0f), Set(d, 0.5f)),
+                               Zero(d)),
+                           Set(d, 1.0f)));
+        case ActivationType::kHardSigmoid:
+            return Min(Max(MulAdd(x, Set(d, 1.0f / 6.0f), Set(d, 0.5f)),
+                           Zero(d)),
+                       Set(d, 1.0f));
+        default:
+            return x;
+    }
+}
+
+inline float Activation(float x, SimpleInfer::ActivationType activation) {
+    using SimpleInfer::ActivationType;
+
+    switch (activation) {
+        case ActivationType::kReLU:
+            return (std::max)(x, 0.0f);
+        case ActivationType::kSiLU:
+            return x / (1.0f + std::exp((std::min)(-x, kActivationExpLimit)));
+        case ActivationType::kSigmoid:
+            return 1.0f /
+                   (1.0f + std::exp((std::min)(-x, kActivationExpLimit)));
+        case ActivationType::kHardSwish:
+            return x * (std::min)((std::max)(x / 6.0f + 0.5f, 0.0f), 1.0f);
+        case ActivationType::kHardSigmoid:
+            return (std::min)((std::max)(x / 6.0f + 0.5f, 0.0f), 1.0f);
+        default:
+            return x;
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace hwy
+
+#endif  // SIMPLE_INFER_SRC_LAYER_SIMD_ACTIVATION_INL_H_
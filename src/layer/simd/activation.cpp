@@ -0,0 +1,118 @@
+#include "activation.h"
+
+#include "activation-inl.h"
+
+namespace hwy {
+namespace HWY_NAMESPACE {
+
+static const Full128<float> d;
+static_assert(4 == Lanes(d), "Lanes(Full128<float>) should be 4");
+using f32x4_t = VFromD<Full128<float>>;
+
+void EpilogueNHWC(const SimpleInfer::Epilogue& epilogue,
+                  size_t spatial,
+                  size_t oc,
+                  float* dst,
+                  size_t ldc) {
+    const float* bias     = epilogue.bias;
+    const float* residual = epilogue.residual;
+
+    size_t oc4 = oc / 4 * 4;
+
+    for (size_t s = 0; s < spatial; ++s) {
+        size_t c = 0;
+        for (; c < oc4; c += 4) {
+            f32x4_t x = LoadU(d, dst + c);
+            if (nullptr != bias) {
+                x = Add(x, LoadU(d, bias + c));
+            }
+
+            x = Activation(d, x, epilogue.activation);
+
+            if (nullptr != residual) {
+                x = Add(x, LoadU(d, residual + c));
+                x = Activation(d, x, epilogue.residual_activation);
+            }
+
+            StoreU(x, d, dst + c);
+        }
+
+        for (; c < oc; ++c) {
+            float x = dst[c];
+            if (nullptr != bias) {
+                x += bias[c];
+            }
+
+            x = Activation(x, epilogue.activation);
+
+            if (nullptr != residual) {
+                x = Activation(x + residual[c], epilogue.residual_activation);
+            }
+
+            dst[c] = x;
+        }
+
+        dst += ldc;
+        if (nullptr != residual) {
+            residual += epilogue.residual_ldc;
+        }
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace hwy
+
+namespace SimpleInfer {
+
+namespace hn = hwy::HWY_NAMESPACE;
+
+bool ParseActivationType(const std::string& type, ActivationType& activation) {
+    if ("nn.ReLU" == type) {
+        activation = ActivationType::kReLU;
+    } else if ("nn.SiLU" == type) {
+        activation = ActivationType::kSiLU;
+    } else if ("nn.Sigmoid" == type) {
+        activation = ActivationType::kSigmoid;
+    } else if ("nn.Hardswish" == type) {
+        activation = ActivationType::kHardSwish;
+    } else if ("nn.Hardsigmoid" == type) {
+        activation = ActivationType::kHardSigmoid;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+Epilogue Epilogue::Offset(size_t pixel, size_t channel) const {
+    Epilogue epilogue = *this;
+
+    if (nullptr != bias) {
+        epilogue.bias = bias + channel;
+    }
+
+    if (nullptr != residual) {
+        epilogue.residual = residual + pixel * residual_ldc + channel;
+    }
+
+    return epilogue;
+}
+
+bool Epilogue::Empty() const {
+    return (nullptr == bias && ActivationType::kNone == activation &&
+            nullptr == residual);
+}
+
+void EpilogueNHWC(const Epilogue& epilogue,
+                  size_t spatial,
+                  size_t oc,
+                  float* dst,
+                  size_t ldc) {
+    if (epilogue.Empty()) {
+        return;
+    }
+
+    return hn::EpilogueNHWC(epilogue, spatial, oc, dst, ldc);
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,46 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_SIMD_ACTIVATION_H_
+#define SIMPLE_INFER_SRC_LAYER_SIMD_ACTIVATION_H_
+
+#include <cstddef>
+#include <string>
+
+namespace SimpleInfer {
+
+// elementwise activation fused into the epilogue of a producer layer
+enum class ActivationType {
+    kNone = 0,
+    kReLU,
+    kSiLU,
+    kSigmoid,
+    kHardSwish,
+    kHardSigmoid
+};
+
+// pnnx operator type, e.g. "nn.SiLU"
+bool ParseActivationType(const std::string& type, ActivationType& activation);
+
+// applied to an NHWC output block in order:
+// residual_activation(activation(dst + bias) + residual)
+// bias and residual may be nullptr, residual has its own row stride
+struct Epilogue {
+    const float* bias                  = nullptr;
+    ActivationType activation          = ActivationType::kNone;
+    const float* residual              = nullptr;
+    size_t residual_ldc                = 0;
+    ActivationType residual_activation = ActivationType::kNone;
+
+    // same epilogue for the block starting at pixel and channel
+    Epilogue Offset(size_t pixel, size_t channel) const;
+
+    bool Empty() const;
+};
+
+void EpilogueNHWC(const Epilogue& epilogue,
+                  size_t spatial,
+                  size_t oc,
+                  float* dst,
+                  size_t ldc);
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYER_SIMD_ACTIVATION_H_
@@ -0,0 +1,292 @@
+#include "depthwise.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "activation-inl.h"
+#include "hwy/highway.h"
+
+namespace hwy {
+namespace HWY_NAMESPACE {
+
+static const Full128<float> d;
+static_assert(4 == Lanes(d), "Lanes(Full128<float>) should be 4");
+using f32x4_t = VFromD<Full128<float>>;
+
+using SimpleInfer::Epilogue;
+
+// one output row of channels [ch, ch + 4), the filter taps stay in registers
+// while the row is swept. epilogue starts at the first pixel of the row
+template<ptrdiff_t kKernel, ptrdiff_t kStride>
+void DepthwiseConv2dNHWCBlock4(const float* src,
+                               ptrdiff_t ih,
+                               ptrdiff_t iw,
+                               ptrdiff_t c,
+                               ptrdiff_t lda,
+                               const float* weight,
+                               ptrdiff_t y0,
+                               ptrdiff_t pad_l,
+                               float* dst,
+                               ptrdiff_t ow,
+                               ptrdiff_t ldc,
+                               const Epilogue& epilogue,
+                               ptrdiff_t ch) {
+    f32x4_t w[kKernel * kKernel];
+    for (ptrdiff_t k = 0; k < kKernel * kKernel; ++k) {
+        w[k] = LoadU(d, weight + k * c + ch);
+    }
+
+    const f32x4_t bias =
+        (nullptr != epilogue.bias) ? LoadU(d, epilogue.bias + ch) : Zero(d);
+
+    // kernel rows inside the image
+    const ptrdiff_t ky_begin = (std::max)(ptrdiff_t(0), -y0);
+    const ptrdiff_t ky_end   = (std::min)(kKernel, ih - y0);
+
+    const bool full_rows = (0 == ky_begin && kKernel == ky_end);
+
+    for (ptrdiff_t ox = 0; ox < ow; ++ox) {
+        const ptrdiff_t x0 = ox * kStride - pad_l;
+
+        const ptrdiff_t kx_begin = (std::max)(ptrdiff_t(0), -x0);
+        const ptrdiff_t kx_end   = (std::min)(kKernel, iw - x0);
+
+        f32x4_t acc = bias;
+
+        if (full_rows && 0 == kx_begin && kKernel == kx_end) {
+            const float* s = src + (y0 * iw + x0) * lda + ch;
+            for (ptrdiff_t ky = 0; ky < kKernel; ++ky) {
+                for (ptrdiff_t kx = 0; kx < kKernel; ++kx) {
+                    acc = MulAdd(LoadU(d, s + (ky * iw + kx) * lda),
+                                 w[ky * kKernel + kx],
+                                 acc);
+                }
+            }
+        } else {
+            for (ptrdiff_t ky = ky_begin; ky < ky_end; ++ky) {
+                for (ptrdiff_t kx = kx_begin; kx < kx_end; ++kx) {
+                    const float* s =
+                        src + ((y0 + ky) * iw + x0 + kx) * lda + ch;
+                    acc = MulAdd(LoadU(d, s), w[ky * kKernel + kx], acc);
+                }
+            }
+        }
+
+        acc = Activation(d, acc, epilogue.activation);
+
+        if (nullptr != epilogue.residual) {
+            acc = Add(acc,
+                      LoadU(d,
+                            epilogue.residual + ox * epilogue.residual_ldc +
+                                ch));
+            acc = Activation(d, acc, epilogue.residual_activation);
+        }
+
+        StoreU(acc, d, dst + ox * ldc + ch);
+    }
+}
+
+// fewer than 4 channels, nothing to vectorize across
+void DepthwiseConv2dNHWCBlock1(const float* src,
+                               ptrdiff_t ih,
+                               ptrdiff_t iw,
+                               ptrdiff_t c,
+                               ptrdiff_t lda,
+                               const float* weight,
+                               ptrdiff_t kernel,
+                               ptrdiff_t stride,
+                               ptrdiff_t y0,
+                               ptrdiff_t pad_l,
+                               float* dst,
+                               ptrdiff_t ow,
+                               ptrdiff_t ldc,
+                               const Epilogue& epilogue,
+                               ptrdiff_t ch) {
+    const ptrdiff_t ky_begin = (std::max)(ptrdiff_t(0), -y0);
+    const ptrdiff_t ky_end   = (std::min)(kernel, ih - y0);
+
+    for (ptrdiff_t ox = 0; ox < ow; ++ox) {
+        const ptrdiff_t x0 = ox * stride - pad_l;
+
+        const ptrdiff_t kx_begin = (std::max)(ptrdiff_t(0), -x0);
+        const ptrdiff_t kx_end   = (std::min)(kernel, iw - x0);
+
+        float acc = (nullptr != epilogue.bias) ? epilogue.bias[ch] : 0.0f;
+
+        for (ptrdiff_t ky = ky_begin; ky < ky_end; ++ky) {
+            for (ptrdiff_t kx = kx_begin; kx < kx_end; ++kx) {
+                acc += src[((y0 + ky) * iw + x0 + kx) * lda + ch] *
+                       weight[(ky * kernel + kx) * c + ch];
+            }
+        }
+
+        acc = Activation(acc, epilogue.activation);
+
+        if (nullptr != epilogue.residual) {
+            acc = Activation(
+                acc + epilogue.residual[ox * epilogue.residual_ldc + ch],
+                epilogue.residual_activation);
+        }
+
+        dst[ox * ldc + ch] = acc;
+    }
+}
+
+template<ptrdiff_t kKernel, ptrdiff_t kStride>
+void DepthwiseConv2dNHWCRows(const float* src,
+                             ptrdiff_t ih,
+                             ptrdiff_t iw,
+                             ptrdiff_t c,
+                             ptrdiff_t lda,
+                             const float* weight,
+                             ptrdiff_t pad_t,
+                             ptrdiff_t pad_l,
+                             float* dst,
+                             ptrdiff_t oh,
+                             ptrdiff_t ow,
+                             ptrdiff_t ldc,
+                             const Epilogue& epilogue,
+                             ptrdiff_t row_begin,
+                             ptrdiff_t row_end) {
+    for (ptrdiff_t row = row_begin; row < row_end; ++row) {
+        const ptrdiff_t n  = row / oh;
+        const ptrdiff_t oy = row % oh;
+        const ptrdiff_t y0 = oy * kStride - pad_t;
+
+        const float* src_image = src + n * ih * iw * lda;
+        float* dst_row         = dst + row * ow * ldc;
+
+        const Epilogue row_epilogue = epilogue.Offset(row * ow, 0);
+
+        ptrdiff_t ch = 0;
+        for (; ch + 4 <= c; ch += 4) {
+            DepthwiseConv2dNHWCBlock4<kKernel, kStride>(src_image,
+                                                        ih,
+                                                        iw,
+                                                        c,
+                                                        lda,
+                                                        weight,
+                                                        y0,
+                                                        pad_l,
+                                                        dst_row,
+                                                        ow,
+                                                        ldc,
+                                                        row_epilogue,
+                                                        ch);
+        }
+
+        if (ch == c) {
+            continue;
+        }
+
+        // the last vector overlaps the previous one, dst is not read back so
+        // the overlapped channels are just written twice
+        if (c >= 4) {
+            DepthwiseConv2dNHWCBlock4<kKernel, kStride>(src_image,
+                                                        ih,
+                                                        iw,
+                                                        c,
+                                                        lda,
+                                                        weight,
+                                                        y0,
+                                                        pad_l,
+                                                        dst_row,
+                                                        ow,
+                                                        ldc,
+                                                        row_epilogue,
+                                                        c - 4);
+            continue;
+        }
+
+        for (; ch < c; ++ch) {
+            DepthwiseConv2dNHWCBlock1(src_image,
+                                      ih,
+                                      iw,
+                                      c,
+                                      lda,
+                                      weight,
+                                      kKernel,
+                                      kStride,
+                                      y0,
+                                      pad_l,
+                                      dst_row,
+                                      ow,
+                                      ldc,
+                                      row_epilogue,
+                                      ch);
+        }
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace hwy
+
+namespace SimpleInfer {
+
+namespace hn = hwy::HWY_NAMESPACE;
+
+bool DepthwiseConv2dSupported(size_t kernel, size_t stride) {
+    return ((3 == kernel || 5 == kernel) && (1 == stride || 2 == stride));
+}
+
+void DepthwiseConv2dNHWC(const float* src,
+                         size_t ih,
+                         size_t iw,
+                         size_t c,
+                         size_t lda,
+                         const float* weight,
+                         size_t kernel,
+                         size_t stride,
+                         size_t pad_t,
+                         size_t pad_l,
+                         float* dst,
+                         size_t oh,
+                         size_t ow,
+                         size_t ldc,
+                         const Epilogue& epilogue,
+                         size_t row_begin,
+                         size_t row_end) {
+    // signed from here on, windows start left of and above the image
+    using Rows = void (*)(const float*,
+                          ptrdiff_t,
+                          ptrdiff_t,
+                          ptrdiff_t,
+                          ptrdiff_t,
+                          const float*,
+                          ptrdiff_t,
+                          ptrdiff_t,
+                          float*,
+                          ptrdiff_t,
+                          ptrdiff_t,
+                          ptrdiff_t,
+                          const Epilogue&,
+                          ptrdiff_t,
+                          ptrdiff_t);
+
+    Rows rows = nullptr;
+    if (3 == kernel) {
+        rows = (1 == stride) ? hn::DepthwiseConv2dNHWCRows<3, 1>
+                             : hn::DepthwiseConv2dNHWCRows<3, 2>;
+    } else {
+        rows = (1 == stride) ? hn::DepthwiseConv2dNHWCRows<5, 1>
+                             : hn::DepthwiseConv2dNHWCRows<5, 2>;
+    }
+
+    return rows(src,
+                ih,
+                iw,
+                c,
+                lda,
+                weight,
+                pad_t,
+                pad_l,
+                dst,
+                oh,
+                ow,
+                ldc,
+                epilogue,
+                row_begin,
+                row_end);
+}
+
+}  // namespace SimpleInfer
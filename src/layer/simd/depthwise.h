@@ -0,0 +1,38 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_SIMD_DEPTHWISE_H_
+#define SIMPLE_INFER_SRC_LAYER_SIMD_DEPTHWISE_H_
+
+#include <cstddef>
+
+#include "activation.h"
+
+namespace SimpleInfer {
+
+// square kernel of 3 or 5, stride 1 or 2
+bool DepthwiseConv2dSupported(size_t kernel, size_t stride);
+
+// kernel x kernel conv with one filter per channel, weight is HWIO with a
+// single input channel, i.e. [kernel][kernel][c]. Computes output rows
+// [row_begin, row_end) of the n * oh rows, src pixels are lda apart and dst
+// pixels ldc apart. Zero padding is pad_t and pad_l on top and left, bottom
+// and right padding follow from oh and ow. dst must not overlap src
+void DepthwiseConv2dNHWC(const float* src,
+                         size_t ih,
+                         size_t iw,
+                         size_t c,
+                         size_t lda,
+                         const float* weight,
+                         size_t kernel,
+                         size_t stride,
+                         size_t pad_t,
+                         size_t pad_l,
+                         float* dst,
+                         size_t oh,
+                         size_t ow,
+                         size_t ldc,
+                         const Epilogue& epilogue,
+                         size_t row_begin,
+                         size_t row_end);
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYER_SIMD_DEPTHWISE_H_
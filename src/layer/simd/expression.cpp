@@ -0,0 +1,205 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "hwy/contrib/math/math-inl.h"
+#include "hwy/highway.h"
+
+namespace hwy {
+namespace HWY_NAMESPACE {
+
+static const Full128<float> d;
+static_assert(4 == Lanes(d), "Lanes(Full128<float>) should be 4");
+using f32x4_t = VFromD<Full128<float>>;
+
+template<class VectorOp, class ScalarOp>
+static void Unary(const float* a,
+                  float* dst,
+                  size_t n,
+                  const VectorOp& vector_op,
+                  const ScalarOp& scalar_op) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        StoreU(vector_op(LoadU(d, a + i)), d, dst + i);
+    }
+
+    for (; i < n; ++i) {
+        dst[i] = scalar_op(a[i]);
+    }
+}
+
+template<class VectorOp, class ScalarOp>
+static void Binary(const float* a,
+                   const float* b,
+                   float* dst,
+                   size_t n,
+                   const VectorOp& vector_op,
+                   const ScalarOp& scalar_op) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        StoreU(vector_op(LoadU(d, a + i), LoadU(d, b + i)), d, dst + i);
+    }
+
+    for (; i < n; ++i) {
+        dst[i] = scalar_op(a[i], b[i]);
+    }
+}
+
+void EvaluateExpression(const std::vector<SimpleInfer::ExpressionStep>& steps,
+                        const float** values,
+                        float* scratch,
+                        size_t stride,
+                        size_t n,
+                        float* dst) {
+    using SimpleInfer::ExpressionOpType;
+
+    const size_t num_steps = steps.size();
+
+    for (size_t i = 0; i < num_steps; ++i) {
+        const SimpleInfer::ExpressionStep& step = steps[i];
+        if (ExpressionOpType::kInput == step.type ||
+            ExpressionOpType::kLiteral == step.type) {
+            continue;
+        }
+
+        float* out     = (i + 1 == num_steps) ? dst : scratch + i * stride;
+        const float* a = values[step.a];
+        const float* b = (step.b >= 0) ? values[step.b] : nullptr;
+
+        switch (step.type) {
+            case ExpressionOpType::kAdd:
+                Binary(
+                    a,
+                    b,
+                    out,
+                    n,
+                    [](f32x4_t x, f32x4_t y) { return Add(x, y); },
+                    [](float x, float y) { return x + y; });
+                break;
+            case ExpressionOpType::kSub:
+                Binary(
+                    a,
+                    b,
+                    out,
+                    n,
+                    [](f32x4_t x, f32x4_t y) { return Sub(x, y); },
+                    [](float x, float y) { return x - y; });
+                break;
+            case ExpressionOpType::kMul:
+                Binary(
+                    a,
+                    b,
+                    out,
+                    n,
+                    [](f32x4_t x, f32x4_t y) { return Mul(x, y); },
+                    [](float x, float y) { return x * y; });
+                break;
+            case ExpressionOpType::kDiv:
+                Binary(
+                    a,
+                    b,
+                    out,
+                    n,
+                    [](f32x4_t x, f32x4_t y) { return Div(x, y); },
+                    [](float x, float y) { return x / y; });
+                break;
+            case ExpressionOpType::kMaximum:
+                Binary(
+                    a,
+                    b,
+                    out,
+                    n,
+                    [](f32x4_t x, f32x4_t y) { return Max(x, y); },
+                    [](float x, float y) { return (std::max)(x, y); });
+                break;
+            case ExpressionOpType::kMinimum:
+                Binary(
+                    a,
+                    b,
+                    out,
+                    n,
+                    [](f32x4_t x, f32x4_t y) { return Min(x, y); },
+                    [](float x, float y) { return (std::min)(x, y); });
+                break;
+            case ExpressionOpType::kNeg:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Neg(x); },
+                    [](float x) { return -x; });
+                break;
+            case ExpressionOpType::kAbs:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Abs(x); },
+                    [](float x) { return std::fabs(x); });
+                break;
+            case ExpressionOpType::kSquare:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Mul(x, x); },
+                    [](float x) { return x * x; });
+                break;
+            case ExpressionOpType::kSqrt:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Sqrt(x); },
+                    [](float x) { return std::sqrt(x); });
+                break;
+            case ExpressionOpType::kRsqrt:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Div(Set(d, 1.0f), Sqrt(x)); },
+                    [](float x) { return 1.0f / std::sqrt(x); });
+                break;
+            case ExpressionOpType::kReciprocal:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Div(Set(d, 1.0f), x); },
+                    [](float x) { return 1.0f / x; });
+                break;
+            case ExpressionOpType::kExp:
+                Unary(
+                    a,
+                    out,
+                    n,
+                    [](f32x4_t x) { return Exp(d, x); },
+                    [](float x) { return std::exp(x); });
+                break;
+            default:
+                break;
+        }
+
+        values[i] = out;
+    }
+}
+
+}  // namespace HWY_NAMESPACE
+}  // namespace hwy
+
+namespace SimpleInfer {
+
+namespace hn = hwy::HWY_NAMESPACE;
+
+void EvaluateExpression(const std::vector<ExpressionStep>& steps,
+                        const float** values,
+                        float* scratch,
+                        size_t stride,
+                        size_t n,
+                        float* dst) {
+    return hn::EvaluateExpression(steps, values, scratch, stride, n, dst);
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,50 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_SIMD_EXPRESSION_H_
+#define SIMPLE_INFER_SRC_LAYER_SIMD_EXPRESSION_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace SimpleInfer {
+
+enum class ExpressionOpType {
+    kInput = 0,
+    kLiteral,
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kMaximum,
+    kMinimum,
+    kNeg,
+    kAbs,
+    kSquare,
+    kSqrt,
+    kRsqrt,
+    kReciprocal,
+    kExp
+};
+
+// one node of an elementwise expression, operands a and b are earlier steps,
+// the last step is the result
+struct ExpressionStep {
+    ExpressionOpType type = ExpressionOpType::kInput;
+
+    int input     = 0;
+    float literal = 0.0f;
+
+    int a = -1;
+    int b = -1;
+};
+
+// evaluate a block of n elements, values of kInput and kLiteral steps are set
+// by caller. step i is written to scratch + i * stride, the last one to dst
+void EvaluateExpression(const std::vector<ExpressionStep>& steps,
+                        const float** values,
+                        float* scratch,
+                        size_t stride,
+                        size_t n,
+                        float* dst);
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYER_SIMD_EXPRESSION_H_
@@ -25,47 +25,49 @@
 #ifndef SIMPLE_INFER_SRC_LAYER_SIMD_PARALLEL_H_
 #define SIMPLE_INFER_SRC_LAYER_SIMD_PARALLEL_H_
 
-#include <future>
-#include <thread>
-#include <vector>
+#include <algorithm>
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <unsupported/Eigen/CXX11/ThreadPool>
 
 namespace SimpleInfer {
 
-// void(thread, begin, end)
+// void(thread, begin, end), blocks run on the persistent pool of device, the
+// calling thread takes the first block
 template<typename Function>
-inline void Parallel(size_t begin,
+inline void Parallel(Eigen::ThreadPoolDevice* device,
+                     size_t begin,
                      size_t end,
                      const Function& function,
-                     size_t thread_number,
                      size_t block_align = 1) {
-    static const size_t thread_number_max = std::thread::hardware_concurrency();
-    thread_number = (std::min)(thread_number, thread_number_max);
+    const size_t thread_number =
+        (nullptr == device) ? 1 : (size_t)device->numThreads();
 
     if (thread_number <= 1 || size_t(block_align * 1.5) >= (end - begin)) {
         function(0, begin, end);
     } else {
-        std::vector<std::future<void>> futures;
-
         size_t block_size = (end - begin + thread_number - 1) / thread_number;
         block_size = (block_size + block_align - 1) / block_align * block_align;
 
-        size_t block_begin = begin;
-        size_t block_end   = block_begin + block_size;
+        const size_t block_number = (end - begin + block_size - 1) / block_size;
 
-        for (size_t thread = 0; thread < thread_number && block_begin < end;
-             ++thread) {
-            futures.push_back(std::move(
-                std::async(std::launch::async,
-                           [block_begin, block_end, thread, &function] {
-                               function(thread, block_begin, block_end);
-                           })));
-            block_begin += block_size;
-            block_end = (std::min)(block_begin + block_size, end);
-        }
+        Eigen::Barrier barrier((unsigned int)(block_number - 1));
 
-        for (size_t i = 0; i < futures.size(); ++i) {
-            futures[i].wait();
+        for (size_t thread = 1; thread < block_number; ++thread) {
+            const size_t block_begin = begin + thread * block_size;
+            const size_t block_end =
+                (std::min)(block_begin + block_size, end);
+
+            device->enqueue_with_barrier(
+                &barrier,
+                [block_begin, block_end, thread, &function] {
+                    function(thread, block_begin, block_end);
+                });
         }
+
+        function(0, begin, (std::min)(begin + block_size, end));
+
+        barrier.Wait();
     }
 }
 
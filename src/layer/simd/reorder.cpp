@@ -0,0 +1,53 @@
+#include "reorder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SimpleInfer {
+
+void ReorderChannelBlocks(const float* src,
+                          size_t src_block,
+                          float* dst,
+                          size_t dst_block,
+                          size_t hw,
+                          size_t c,
+                          size_t begin,
+                          size_t end) {
+    const size_t src_blocks = (c + src_block - 1) / src_block;
+    const size_t dst_blocks = (c + dst_block - 1) / dst_block;
+
+    for (size_t row = begin; row < end; ++row) {
+        const size_t p  = row % hw;
+        const size_t cb = row / hw % dst_blocks;
+        const size_t n  = row / hw / dst_blocks;
+
+        float* dst_row = dst + row * dst_block;
+
+        const size_t channel_begin = cb * dst_block;
+        const size_t channel_end   = (std::min)(channel_begin + dst_block, c);
+
+        // a dst block spans one or more runs of src blocks
+        size_t channel = channel_begin;
+        while (channel < channel_end) {
+            const size_t sb     = channel / src_block;
+            const size_t offset = channel % src_block;
+            const size_t length =
+                (std::min)(src_block - offset, channel_end - channel);
+
+            const float* src_run =
+                src + ((n * src_blocks + sb) * hw + p) * src_block + offset;
+
+            memcpy(dst_row + channel - channel_begin,
+                   src_run,
+                   length * sizeof(float));
+
+            channel += length;
+        }
+
+        for (size_t i = channel_end - channel_begin; i < dst_block; ++i) {
+            dst_row[i] = 0.0f;
+        }
+    }
+}
+
+}  // namespace SimpleInfer
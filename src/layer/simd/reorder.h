@@ -0,0 +1,22 @@
+#ifndef SIMPLE_INFER_SRC_LAYER_SIMD_REORDER_H_
+#define SIMPLE_INFER_SRC_LAYER_SIMD_REORDER_H_
+
+#include <cstddef>
+
+namespace SimpleInfer {
+
+// channels of n * hw pixels stored as [n][ceil(c / block)][hw][block], NHWC is
+// the case block == c. Copy rows [begin, end) of dst, a row is one block of
+// one pixel, padded channels of dst are set to zero.
+void ReorderChannelBlocks(const float* src,
+                          size_t src_block,
+                          float* dst,
+                          size_t dst_block,
+                          size_t hw,
+                          size_t c,
+                          size_t begin,
+                          size_t end);
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYER_SIMD_REORDER_H_
@@ -24,9 +24,12 @@
 
 #include "winograd_helper.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <vector>
 
+#include "activation-inl.h"
 #include "hwy/highway.h"
 
 namespace hwy {
@@ -36,6 +39,9 @@ static const Full128<float> d;
 static_assert(4 == Lanes(d), "Lanes(Full128<float>) should be 4");
 using f32x4_t = VFromD<Full128<float>>;
 
+using SimpleInfer::ActivationType;
+using SimpleInfer::Epilogue;
+
 // [3(kh)][3(kw)][ic][oc] -> [4(gh)][4(gw)][oc/4][ic][4(oc)]
 void Conv3x3s1Winograd23TransformKernelPack4(const float* src,
                                              size_t ic,
@@ -409,14 +415,33 @@ void Conv3x3s1Winograd23TransformInputFt<1>(const float* src,
     }
 }
 
+// rows or columns [start, end) of a tile of size at offset lie inside
+// [0, extent), the rest is padding
+inline void Conv3x3s1WinogradClip(ptrdiff_t offset,
+                                  size_t extent,
+                                  size_t size,
+                                  size_t& start,
+                                  size_t& end) {
+    start = (size_t)(std::min)((std::max)(-offset, (ptrdiff_t)0),
+                               (ptrdiff_t)size);
+    end   = (size_t)(std::min)((std::max)((ptrdiff_t)extent - offset,
+                                          (ptrdiff_t)start),
+                               (ptrdiff_t)size);
+}
+
 template<size_t F>
 void Conv3x3s1Winograd23TransformInput(const float* src,
                                        size_t ih,
                                        size_t iw,
                                        size_t ic,
-                                       bool pad,
+                                       size_t pad_t,
+                                       size_t pad_l,
+                                       size_t ow,
                                        float* dst,
-                                       size_t dst_stride) {
+                                       size_t dst_stride,
+                                       size_t tile_stride,
+                                       size_t tile_begin,
+                                       size_t tile_end) {
     assert(1 == F || 4 == F);
 
     if (ic < F) {
@@ -424,158 +449,50 @@ void Conv3x3s1Winograd23TransformInput(const float* src,
                                                     ih,
                                                     iw,
                                                     ic,
-                                                    pad,
+                                                    pad_t,
+                                                    pad_l,
+                                                    ow,
                                                     dst,
-                                                    dst_stride);
+                                                    dst_stride,
+                                                    tile_stride,
+                                                    tile_begin,
+                                                    tile_end);
     }
 
-    size_t oh  = (pad ? ih : ih - 2);
-    size_t ow  = (pad ? iw : iw - 2);
-    size_t oh2 = oh / 2 * 2;
-    size_t ow2 = ow / 2 * 2;
-
-    size_t tile_h = (oh + 1) / 2;
-    size_t tile_w = (ow + 1) / 2;
-
-    size_t nose_h = (std::min)((size_t)4, oh + 1);
-    size_t nose_w = (std::min)((size_t)4, ow + 1);
-
-    size_t start = (pad ? 2 : 0);
-    if (pad) {
-        if (oh == oh2) {
-            oh2 -= 2;
-        }
+    const size_t tiles_w = (ow + 1) / 2;
 
-        if (ow == ow2) {
-            ow2 -= 2;
-        }
+    dst += tile_begin * tile_stride;
 
-        src -= (iw + 1) * ic;
-    }
+    for (size_t tile = tile_begin; tile < tile_end; ++tile) {
+        // top left of the 4x4 input, rows and columns outside are padding
+        const ptrdiff_t y = (ptrdiff_t)(tile / tiles_w * 2) - (ptrdiff_t)pad_t;
+        const ptrdiff_t x = (ptrdiff_t)(tile % tiles_w * 2) - (ptrdiff_t)pad_l;
 
-    size_t tail_h = oh - oh2 + (pad ? 1 : 2);
-    size_t tail_w = ow - ow2 + (pad ? 1 : 2);
+        size_t row_start, row_end, col_start, col_end;
+        Conv3x3s1WinogradClip(y, ih, 4, row_start, row_end);
+        Conv3x3s1WinogradClip(x, iw, 4, col_start, col_end);
 
-    size_t row = 0;
-    size_t col = 0;
+        const float* tile_src = src + (y * (ptrdiff_t)iw + x) * (ptrdiff_t)ic;
 
-    if (pad) {
-        if (pad) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src,
+        if (0 == row_start && 4 == row_end && 0 == col_start && 4 == col_end) {
+            Conv3x3s1Winograd23TransformInputFt<F>(tile_src,
                                                    iw,
                                                    ic,
-                                                   1,
-                                                   nose_h,
-                                                   1,
-                                                   nose_w,
                                                    dst,
                                                    dst_stride);
-            dst += ic;
-        }
-
-        for (col = start; col < ow2; col += 2) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + col * ic,
+        } else {
+            Conv3x3s1Winograd23TransformInputFt<F>(tile_src,
                                                    iw,
                                                    ic,
-                                                   1,
-                                                   nose_h,
-                                                   0,
-                                                   4,
+                                                   row_start,
+                                                   row_end,
+                                                   col_start,
+                                                   col_end,
                                                    dst,
                                                    dst_stride);
-            dst += ic;
         }
 
-        if (col < ow) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + col * ic,
-                                                   iw,
-                                                   ic,
-                                                   1,
-                                                   nose_h,
-                                                   0,
-                                                   tail_w,
-                                                   dst,
-                                                   dst_stride),
-                dst += ic;
-        }
-    }
-
-    for (row = start; row < oh2; row += 2) {
-        if (pad) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + row * iw * ic,
-                                                   iw,
-                                                   ic,
-                                                   0,
-                                                   4,
-                                                   1,
-                                                   nose_w,
-                                                   dst,
-                                                   dst_stride);
-            dst += ic;
-        }
-
-        for (col = start; col < ow2; col += 2) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + (row * iw + col) * ic,
-                                                   iw,
-                                                   ic,
-                                                   dst,
-                                                   dst_stride);
-            dst += ic;
-        }
-
-        if (col < ow) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + (row * iw + col) * ic,
-                                                   iw,
-                                                   ic,
-                                                   0,
-                                                   4,
-                                                   0,
-                                                   tail_w,
-                                                   dst,
-                                                   dst_stride);
-            dst += ic;
-        }
-    }
-
-    if (row < ow) {
-        if (pad) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + row * iw * ic,
-                                                   iw,
-                                                   ic,
-                                                   0,
-                                                   tail_h,
-                                                   1,
-                                                   nose_w,
-                                                   dst,
-                                                   dst_stride);
-            dst += ic;
-        }
-
-        for (col = start; col < ow2; col += 2) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + (row * iw + col) * ic,
-                                                   iw,
-                                                   ic,
-                                                   0,
-                                                   tail_h,
-                                                   0,
-                                                   4,
-                                                   dst,
-                                                   dst_stride);
-            dst += ic;
-        }
-
-        if (col < ow) {
-            Conv3x3s1Winograd23TransformInputFt<F>(src + (row * iw + col) * ic,
-                                                   iw,
-                                                   ic,
-                                                   0,
-                                                   tail_h,
-                                                   0,
-                                                   tail_w,
-                                                   dst,
-                                                   dst_stride);
-            dst += ic;
-        }
+        dst += tile_stride;
     }
 }
 
@@ -651,25 +568,98 @@ void Conv3x3s1Winograd23TransformOutputLoad1(const float* src,
     dst[3] = temp[3] - temp[5] - temp[7];
 }
 
+// epilogue while the tile is still in registers, only the first row_end x
+// col_end outputs of the tile exist
+void Conv3x3s1Winograd23TransformOutputEpilogue4(const Epilogue& epilogue,
+                                                 size_t c,
+                                                 size_t ow,
+                                                 size_t row_end,
+                                                 size_t col_end,
+                                                 f32x4_t dst[4]) {
+    if (nullptr != epilogue.bias) {
+        f32x4_t b = LoadU(d, epilogue.bias + c);
+
+        dst[0] = Add(dst[0], b);
+        dst[1] = Add(dst[1], b);
+        dst[2] = Add(dst[2], b);
+        dst[3] = Add(dst[3], b);
+    }
+
+    if (ActivationType::kNone != epilogue.activation) {
+        dst[0] = Activation(d, dst[0], epilogue.activation);
+        dst[1] = Activation(d, dst[1], epilogue.activation);
+        dst[2] = Activation(d, dst[2], epilogue.activation);
+        dst[3] = Activation(d, dst[3], epilogue.activation);
+    }
+
+    if (nullptr != epilogue.residual) {
+        const size_t residual_stride = ow * epilogue.residual_ldc;
+
+        for (size_t row = 0; row < row_end; ++row) {
+            for (size_t col = 0; col < col_end; ++col) {
+                const float* residual = epilogue.residual +
+                                        row * residual_stride +
+                                        col * epilogue.residual_ldc + c;
+
+                f32x4_t& x = dst[row * 2 + col];
+
+                x = Activation(d,
+                               Add(x, LoadU(d, residual)),
+                               epilogue.residual_activation);
+            }
+        }
+    }
+}
+
+void Conv3x3s1Winograd23TransformOutputEpilogue1(const Epilogue& epilogue,
+                                                 size_t c,
+                                                 size_t ow,
+                                                 size_t row_end,
+                                                 size_t col_end,
+                                                 float dst[4]) {
+    const float b = (nullptr != epilogue.bias) ? epilogue.bias[c] : 0.0f;
+
+    dst[0] = Activation(dst[0] + b, epilogue.activation);
+    dst[1] = Activation(dst[1] + b, epilogue.activation);
+    dst[2] = Activation(dst[2] + b, epilogue.activation);
+    dst[3] = Activation(dst[3] + b, epilogue.activation);
+
+    if (nullptr != epilogue.residual) {
+        const size_t residual_stride = ow * epilogue.residual_ldc;
+
+        for (size_t row = 0; row < row_end; ++row) {
+            for (size_t col = 0; col < col_end; ++col) {
+                const float* residual = epilogue.residual +
+                                        row * residual_stride +
+                                        col * epilogue.residual_ldc + c;
+
+                float& x = dst[row * 2 + col];
+
+                x = Activation(x + residual[0], epilogue.residual_activation);
+            }
+        }
+    }
+}
+
 void Conv3x3s1Winograd23TransformOutputstore4(const f32x4_t src[4],
                                               float* dst,
                                               size_t dst_stride,
-                                              size_t oc) {
-    StoreU(src[0], d, dst + 0 * dst_stride + 0 * oc);
-    StoreU(src[1], d, dst + 0 * dst_stride + 1 * oc);
-    StoreU(src[2], d, dst + 1 * dst_stride + 0 * oc);
-    StoreU(src[3], d, dst + 1 * dst_stride + 1 * oc);
+                                              size_t ldc) {
+    StoreU(src[0], d, dst + 0 * dst_stride + 0 * ldc);
+    StoreU(src[1], d, dst + 0 * dst_stride + 1 * ldc);
+    StoreU(src[2], d, dst + 1 * dst_stride + 0 * ldc);
+    StoreU(src[3], d, dst + 1 * dst_stride + 1 * ldc);
 }
 
 void Conv3x3s1Winograd23TransformOutputstore4(const f32x4_t src[4],
                                               float* dst,
                                               size_t dst_stride,
-                                              size_t oc,
+                                              size_t ldc,
                                               size_t row_end,
                                               size_t col_end) {
     for (size_t row = 0; row < row_end; ++row) {
         for (size_t col = 0; col < col_end; ++col) {
-            StoreU(src[row * 2 + col], d, dst + row * dst_stride + col * oc);
+            StoreU(src[row * 2 + col], d, dst + row * dst_stride + col * ldc);
         }
     }
 }
@@ -679,7 +669,9 @@ void Conv3x3s1Winograd23TransformOutputFt(const float* src,
                                           size_t src_stride,
                                           float* dst,
                                           size_t ow,
-                                          size_t oc);
+                                          size_t oc,
+                                          size_t ldc,
+                                          const Epilogue& epilogue);
 
 template<size_t F>
 void Conv3x3s1Winograd23TransformOutputFt(const float* src,
@@ -687,6 +679,8 @@ void Conv3x3s1Winograd23TransformOutputFt(const float* src,
                                           float* dst,
                                           size_t ow,
                                           size_t oc,
+                                          size_t ldc,
+                                          const Epilogue& epilogue,
                                           size_t row_end,
                                           size_t col_end);
 
@@ -695,25 +689,42 @@ void Conv3x3s1Winograd23TransformOutputFt<4>(const float* src,
                                              size_t src_stride,
                                              float* dst,
                                              size_t ow,
-                                             size_t oc) {
-    size_t dst_stride = ow * oc;
+                                             size_t oc,
+                                             size_t ldc,
+                                             const Epilogue& epilogue) {
+    size_t dst_stride = ow * ldc;
     size_t oc4        = oc / 4 * 4;
 
     f32x4_t temp[4];
 
     for (size_t c = 0; c < oc4; c += 4) {
         Conv3x3s1Winograd23TransformOutputLoad16(src + c, src_stride, temp);
-        Conv3x3s1Winograd23TransformOutputstore4(temp, dst + c, dst_stride, oc);
+        Conv3x3s1Winograd23TransformOutputEpilogue4(epilogue,
+                                                    c,
+                                                    ow,
+                                                    2,
+                                                    2,
+                                                    temp);
+        Conv3x3s1Winograd23TransformOutputstore4(temp,
+                                                 dst + c,
+                                                 dst_stride,
+                                                 ldc);
     }
 
     if (oc4 < oc) {
         Conv3x3s1Winograd23TransformOutputLoad16(src + oc - 4,
                                                  src_stride,
                                                  temp);
+        Conv3x3s1Winograd23TransformOutputEpilogue4(epilogue,
+                                                    oc - 4,
+                                                    ow,
+                                                    2,
+                                                    2,
+                                                    temp);
         Conv3x3s1Winograd23TransformOutputstore4(temp,
                                                  dst + oc - 4,
                                                  dst_stride,
-                                                 oc);
+                                                 ldc);
     }
 }
 
@@ -723,19 +734,27 @@ void Conv3x3s1Winograd23TransformOutputFt<4>(const float* src,
                                              float* dst,
                                              size_t ow,
                                              size_t oc,
+                                             size_t ldc,
+                                             const Epilogue& epilogue,
                                              size_t row_end,
                                              size_t col_end) {
-    size_t dst_stride = ow * oc;
+    size_t dst_stride = ow * ldc;
     size_t oc4        = oc / 4 * 4;
 
     f32x4_t temp[4];
 
     for (size_t c = 0; c < oc4; c += 4) {
         Conv3x3s1Winograd23TransformOutputLoad16(src + c, src_stride, temp);
+        Conv3x3s1Winograd23TransformOutputEpilogue4(epilogue,
+                                                    c,
+                                                    ow,
+                                                    row_end,
+                                                    col_end,
+                                                    temp);
         Conv3x3s1Winograd23TransformOutputstore4(temp,
                                                  dst + c,
                                                  dst_stride,
-                                                 oc,
+                                                 ldc,
                                                  row_end,
                                                  col_end);
     }
@@ -744,10 +763,16 @@ void Conv3x3s1Winograd23TransformOutputFt<4>(const float* src,
         Conv3x3s1Winograd23TransformOutputLoad16(src + oc - 4,
                                                  src_stride,
                                                  temp);
+        Conv3x3s1Winograd23TransformOutputEpilogue4(epilogue,
+                                                    oc - 4,
+                                                    ow,
+                                                    row_end,
+                                                    col_end,
+                                                    temp);
         Conv3x3s1Winograd23TransformOutputstore4(temp,
                                                  dst + oc - 4,
                                                  dst_stride,
-                                                 oc,
+                                                 ldc,
                                                  row_end,
                                                  col_end);
     }
@@ -758,18 +783,26 @@ void Conv3x3s1Winograd23TransformOutputFt<1>(const float* src,
                                              size_t src_stride,
                                              float* dst,
                                              size_t ow,
-                                             size_t oc) {
-    size_t dst_stride = ow * oc;
+                                             size_t oc,
+                                             size_t ldc,
+                                             const Epilogue& epilogue) {
+    size_t dst_stride = ow * ldc;
 
     for (size_t c = 0; c < oc; ++c) {
         float temp[4];
 
         Conv3x3s1Winograd23TransformOutputLoad1(src, src_stride, temp);
+        Conv3x3s1Winograd23TransformOutputEpilogue1(epilogue,
+                                                    c,
+                                                    ow,
+                                                    2,
+                                                    2,
+                                                    temp);
 
-        dst[0 * dst_stride + 0 * oc] = temp[0];
-        dst[0 * dst_stride + 1 * oc] = temp[1];
-        dst[1 * dst_stride + 0 * oc] = temp[2];
-        dst[1 * dst_stride + 1 * oc] = temp[3];
+        dst[0 * dst_stride + 0 * ldc] = temp[0];
+        dst[0 * dst_stride + 1 * ldc] = temp[1];
+        dst[1 * dst_stride + 0 * ldc] = temp[2];
+        dst[1 * dst_stride + 1 * ldc] = temp[3];
 
         src += 1;
         dst += 1;
@@ -782,18 +815,26 @@ void Conv3x3s1Winograd23TransformOutputFt<1>(const float* src,
                                              float* dst,
                                              size_t ow,
                                              size_t oc,
+                                             size_t ldc,
+                                             const Epilogue& epilogue,
                                              size_t row_end,
                                              size_t col_end) {
-    size_t dst_stride = ow * oc;
+    size_t dst_stride = ow * ldc;
 
     for (size_t c = 0; c < oc; ++c) {
         float temp[4];
 
         Conv3x3s1Winograd23TransformOutputLoad1(src, src_stride, temp);
+        Conv3x3s1Winograd23TransformOutputEpilogue1(epilogue,
+                                                    c,
+                                                    ow,
+                                                    row_end,
+                                                    col_end,
+                                                    temp);
 
         for (size_t row = 0; row < row_end; ++row) {
             for (size_t col = 0; col < col_end; ++col) {
-                dst[row * dst_stride + col * oc] = temp[row * 2 + col];
+                dst[row * dst_stride + col * ldc] = temp[row * 2 + col];
             }
         }
 
@@ -808,7 +849,12 @@ void Conv3x3s1Winograd23TransformOutput(const float* src,
                                         float* dst,
                                         size_t oh,
                                         size_t ow,
-                                        size_t oc) {
+                                        size_t oc,
+                                        size_t ldc,
+                                        const Epilogue& epilogue,
+                                        size_t tile_stride,
+                                        size_t tile_begin,
+                                        size_t tile_end) {
     assert(1 == F || 4 == F);
 
     if (oc < F) {
@@ -817,60 +863,437 @@ void Conv3x3s1Winograd23TransformOutput(const float* src,
                                                      dst,
                                                      oh,
                                                      ow,
-                                                     oc);
+                                                     oc,
+                                                     ldc,
+                                                     epilogue,
+                                                     tile_stride,
+                                                     tile_begin,
+                                                     tile_end);
     }
 
-    size_t oh2 = oh / 2 * 2;
-    size_t ow2 = ow / 2 * 2;
+    const size_t tiles_w = (ow + 1) / 2;
+
+    src += tile_begin * tile_stride;
+
+    for (size_t tile = tile_begin; tile < tile_end; ++tile) {
+        const size_t row = tile / tiles_w * 2;
+        const size_t col = tile % tiles_w * 2;
+
+        const size_t row_end = (std::min)((size_t)2, oh - row);
+        const size_t col_end = (std::min)((size_t)2, ow - col);
+
+        if (2 == row_end && 2 == col_end) {
+            Conv3x3s1Winograd23TransformOutputFt<F>(
+                src,
+                src_stride,
+                dst + (row * ow + col) * ldc,
+                ow,
+                oc,
+                ldc,
+                epilogue.Offset(row * ow + col, 0));
+        } else {
+            Conv3x3s1Winograd23TransformOutputFt<F>(
+                src,
+                src_stride,
+                dst + (row * ow + col) * ldc,
+                ow,
+                oc,
+                ldc,
+                epilogue.Offset(row * ow + col, 0),
+                row_end,
+                col_end);
+        }
 
-    size_t row = 0;
-    size_t col = 0;
+        src += tile_stride;
+    }
+}
 
-    for (row = 0; row < oh2; row += 2) {
-        for (col = 0; col < ow2; col += 2) {
-            Conv3x3s1Winograd23TransformOutputFt<F>(src,
-                                                    src_stride,
-                                                    dst + (row * ow + col) * oc,
-                                                    ow,
-                                                    oc);
-            src += oc;
+// G of F(4x4,3x3), 6x3
+static const float kWinograd43G[6][3] = {
+    {1.0f / 4.0f, 0.0f, 0.0f},
+    {-1.0f / 6.0f, -1.0f / 6.0f, -1.0f / 6.0f},
+    {-1.0f / 6.0f, 1.0f / 6.0f, -1.0f / 6.0f},
+    {1.0f / 24.0f, 1.0f / 12.0f, 1.0f / 6.0f},
+    {1.0f / 24.0f, -1.0f / 12.0f, 1.0f / 6.0f},
+    {0.0f, 0.0f, 1.0f}};
+
+// [3(kh)][3(kw)][ic][oc] -> [6(gh)][6(gw)][oc/4][ic][4(oc)]
+void Conv3x3s1Winograd43TransformKernelPack4(const float* src,
+                                             size_t ic,
+                                             size_t oc,
+                                             float* dst) {
+    // padding oc with 4
+    size_t oc_up4 = (oc + 3) / 4 * 4;
+
+    // once per layer at init, scalar is enough
+    for (size_t i = 0; i < ic; ++i) {
+        for (size_t j = 0; j < oc_up4; ++j) {
+            float kernel[9] = {0};
+            if (j < oc) {
+                for (size_t k = 0; k < 9; ++k) {
+                    kernel[k] = src[k * ic * oc + i * oc + j];
+                }
+            }
+
+            // G g, 6x3
+            float temp[6][3];
+            for (size_t row = 0; row < 6; ++row) {
+                for (size_t col = 0; col < 3; ++col) {
+                    temp[row][col] = kWinograd43G[row][0] * kernel[0 + col] +
+                                     kWinograd43G[row][1] * kernel[3 + col] +
+                                     kWinograd43G[row][2] * kernel[6 + col];
+                }
+            }
+
+            // G g GT, 6x6
+            for (size_t row = 0; row < 6; ++row) {
+                for (size_t col = 0; col < 6; ++col) {
+                    const size_t k = row * 6 + col;
+
+                    dst[(k * oc_up4 + j / 4 * 4) * ic + i * 4 + j % 4] =
+                        temp[row][0] * kWinograd43G[col][0] +
+                        temp[row][1] * kWinograd43G[col][1] +
+                        temp[row][2] * kWinograd43G[col][2];
+                }
+            }
         }
+    }
+}
 
-        if (col < ow) {
-            Conv3x3s1Winograd23TransformOutputFt<F>(src,
-                                                    src_stride,
-                                                    dst + (row * ow + col) * oc,
-                                                    ow,
-                                                    oc,
-                                                    2,
-                                                    ow - col);
-            src += oc;
+// one row or column of BT d B
+inline void Conv3x3s1Winograd43TransformInput6(const f32x4_t* src,
+                                               size_t src_step,
+                                               f32x4_t* dst,
+                                               size_t dst_step) {
+    const f32x4_t s0 = src[0 * src_step];
+    const f32x4_t s1 = src[1 * src_step];
+    const f32x4_t s2 = src[2 * src_step];
+    const f32x4_t s3 = src[3 * src_step];
+    const f32x4_t s4 = src[4 * src_step];
+    const f32x4_t s5 = src[5 * src_step];
+
+    const f32x4_t _2 = Set(d, 2.0f);
+    const f32x4_t _4 = Set(d, 4.0f);
+    const f32x4_t _5 = Set(d, 5.0f);
+
+    dst[0 * dst_step] = Add(Sub(Mul(_4, s0), Mul(_5, s2)), s4);
+    dst[1 * dst_step] = Sub(Add(s3, s4), Mul(_4, Add(s1, s2)));
+    dst[2 * dst_step] = MulAdd(_4, Sub(s1, s2), Sub(s4, s3));
+    dst[3 * dst_step] = MulAdd(_2, Sub(s3, s1), Sub(s4, s2));
+    dst[4 * dst_step] = MulAdd(_2, Sub(s1, s3), Sub(s4, s2));
+    dst[5 * dst_step] = Add(Sub(Mul(_4, s1), Mul(_5, s3)), s5);
+}
+
+// 6x6 input of the tile at (y, x) for channels [c, c + 4), rows and
+// columns outside [start, end) are padding
+inline void Conv3x3s1Winograd43TransformInput4t(const float* src,
+                                                size_t iw,
+                                                size_t ic,
+                                                ptrdiff_t y,
+                                                ptrdiff_t x,
+                                                size_t row_start,
+                                                size_t row_end,
+                                                size_t col_start,
+                                                size_t col_end,
+                                                size_t c,
+                                                float* dst,
+                                                size_t dst_stride) {
+    f32x4_t temp[36];
+    f32x4_t temp_col[36];
+
+    if (0 != row_start || 6 != row_end || 0 != col_start || 6 != col_end) {
+        for (size_t i = 0; i < 36; ++i) {
+            temp[i] = Zero(d);
         }
     }
 
-    if (row < oh) {
-        for (col = 0; col < ow2; col += 2) {
-            Conv3x3s1Winograd23TransformOutputFt<F>(src,
-                                                    src_stride,
-                                                    dst + (row * ow + col) * oc,
-                                                    ow,
-                                                    oc,
-                                                    oh - row,
-                                                    2);
-            src += oc;
+    for (size_t row = row_start; row < row_end; ++row) {
+        const ptrdiff_t pixel =
+            (y + (ptrdiff_t)row) * (ptrdiff_t)iw + x + (ptrdiff_t)col_start;
+
+        const float* src_row = src + pixel * (ptrdiff_t)ic + c;
+        for (size_t col = col_start; col < col_end; ++col) {
+            temp[row * 6 + col] = LoadU(d, src_row);
+            src_row += ic;
         }
+    }
 
-        if (col < ow) {
-            Conv3x3s1Winograd23TransformOutputFt<F>(src,
-                                                    src_stride,
-                                                    dst + (row * ow + col) * oc,
-                                                    ow,
-                                                    oc,
-                                                    oh - row,
-                                                    ow - col);
-            src += oc;
+    for (size_t col = 0; col < 6; ++col) {
+        Conv3x3s1Winograd43TransformInput6(temp + col, 6, temp_col + col, 6);
+    }
+
+    for (size_t row = 0; row < 6; ++row) {
+        Conv3x3s1Winograd43TransformInput6(temp_col + row * 6,
+                                           1,
+                                           temp + row * 6,
+                                           1);
+    }
+
+    for (size_t i = 0; i < 36; ++i) {
+        StoreU(temp[i], d, dst + i * dst_stride + c);
+    }
+}
+
+inline void Conv3x3s1Winograd43TransformInputTile(const float* src,
+                                                  size_t iw,
+                                                  size_t ic,
+                                                  ptrdiff_t y,
+                                                  ptrdiff_t x,
+                                                  size_t row_start,
+                                                  size_t row_end,
+                                                  size_t col_start,
+                                                  size_t col_end,
+                                                  float* dst,
+                                                  size_t dst_stride) {
+    assert(ic >= 4);
+
+    size_t ic4 = ic / 4 * 4;
+
+    for (size_t c = 0; c < ic4; c += 4) {
+        Conv3x3s1Winograd43TransformInput4t(src,
+                                            iw,
+                                            ic,
+                                            y,
+                                            x,
+                                            row_start,
+                                            row_end,
+                                            col_start,
+                                            col_end,
+                                            c,
+                                            dst,
+                                            dst_stride);
+    }
+
+    // overlap the last full vector
+    if (ic4 < ic) {
+        Conv3x3s1Winograd43TransformInput4t(src,
+                                            iw,
+                                            ic,
+                                            y,
+                                            x,
+                                            row_start,
+                                            row_end,
+                                            col_start,
+                                            col_end,
+                                            ic - 4,
+                                            dst,
+                                            dst_stride);
+    }
+}
+
+void Conv3x3s1Winograd43TransformInput(const float* src,
+                                       size_t ih,
+                                       size_t iw,
+                                       size_t ic,
+                                       size_t pad_t,
+                                       size_t pad_l,
+                                       size_t ow,
+                                       float* dst,
+                                       size_t dst_stride,
+                                       size_t tile_stride,
+                                       size_t tile_begin,
+                                       size_t tile_end) {
+    const size_t tiles_w = (ow + 3) / 4;
+
+    dst += tile_begin * tile_stride;
+
+    for (size_t tile = tile_begin; tile < tile_end; ++tile) {
+        const ptrdiff_t y = (ptrdiff_t)(tile / tiles_w * 4) - (ptrdiff_t)pad_t;
+        const ptrdiff_t x = (ptrdiff_t)(tile % tiles_w * 4) - (ptrdiff_t)pad_l;
+
+        size_t row_start, row_end, col_start, col_end;
+        Conv3x3s1WinogradClip(y, ih, 6, row_start, row_end);
+        Conv3x3s1WinogradClip(x, iw, 6, col_start, col_end);
+
+        Conv3x3s1Winograd43TransformInputTile(src,
+                                              iw,
+                                              ic,
+                                              y,
+                                              x,
+                                              row_start,
+                                              row_end,
+                                              col_start,
+                                              col_end,
+                                              dst,
+                                              dst_stride);
+        dst += tile_stride;
+    }
+}
+
+// one row or column of AT m A
+inline void Conv3x3s1Winograd43TransformOutput6(const f32x4_t* src,
+                                                size_t src_step,
+                                                f32x4_t* dst,
+                                                size_t dst_step) {
+    const f32x4_t _1a2 = Add(src[1 * src_step], src[2 * src_step]);
+    const f32x4_t _1s2 = Sub(src[1 * src_step], src[2 * src_step]);
+    const f32x4_t _3a4 = Add(src[3 * src_step], src[4 * src_step]);
+    const f32x4_t _3s4 = Sub(src[3 * src_step], src[4 * src_step]);
+
+    dst[0 * dst_step] = Add(Add(src[0 * src_step], _1a2), _3a4);
+    dst[1 * dst_step] = MulAdd(Set(d, 2.0f), _3s4, _1s2);
+    dst[2 * dst_step] = MulAdd(Set(d, 4.0f), _3a4, _1a2);
+    dst[3 * dst_step] =
+        Add(MulAdd(Set(d, 8.0f), _3s4, _1s2), src[5 * src_step]);
+}
+
+// epilogue of a 4x4 tile, only the first row_end x col_end outputs exist
+void Conv3x3s1Winograd43TransformOutputEpilogue(const Epilogue& epilogue,
+                                                size_t c,
+                                                size_t ow,
+                                                size_t row_end,
+                                                size_t col_end,
+                                                f32x4_t dst[16]) {
+    if (nullptr != epilogue.bias) {
+        const f32x4_t b = LoadU(d, epilogue.bias + c);
+        for (size_t i = 0; i < 16; ++i) {
+            dst[i] = Add(dst[i], b);
         }
     }
+
+    if (ActivationType::kNone != epilogue.activation) {
+        for (size_t i = 0; i < 16; ++i) {
+            dst[i] = Activation(d, dst[i], epilogue.activation);
+        }
+    }
+
+    if (nullptr != epilogue.residual) {
+        const size_t residual_stride = ow * epilogue.residual_ldc;
+
+        for (size_t row = 0; row < row_end; ++row) {
+            for (size_t col = 0; col < col_end; ++col) {
+                const float* residual = epilogue.residual +
+                                        row * residual_stride +
+                                        col * epilogue.residual_ldc + c;
+
+                f32x4_t& x = dst[row * 4 + col];
+
+                x = Activation(d,
+                               Add(x, LoadU(d, residual)),
+                               epilogue.residual_activation);
+            }
+        }
+    }
+}
+
+inline void Conv3x3s1Winograd43TransformOutput4t(const float* src,
+                                                 size_t src_stride,
+                                                 float* dst,
+                                                 size_t ow,
+                                                 size_t ldc,
+                                                 const Epilogue& epilogue,
+                                                 size_t row_end,
+                                                 size_t col_end,
+                                                 size_t c) {
+    size_t dst_stride = ow * ldc;
+
+    f32x4_t temp[36];
+    f32x4_t temp_col[24];
+
+    for (size_t i = 0; i < 36; ++i) {
+        temp[i] = LoadU(d, src + i * src_stride + c);
+    }
+
+    for (size_t col = 0; col < 6; ++col) {
+        Conv3x3s1Winograd43TransformOutput6(temp + col, 6, temp_col + col, 6);
+    }
+
+    for (size_t row = 0; row < 4; ++row) {
+        Conv3x3s1Winograd43TransformOutput6(temp_col + row * 6,
+                                            1,
+                                            temp + row * 4,
+                                            1);
+    }
+
+    Conv3x3s1Winograd43TransformOutputEpilogue(epilogue,
+                                               c,
+                                               ow,
+                                               row_end,
+                                               col_end,
+                                               temp);
+
+    for (size_t row = 0; row < row_end; ++row) {
+        for (size_t col = 0; col < col_end; ++col) {
+            StoreU(temp[row * 4 + col],
+                   d,
+                   dst + row * dst_stride + col * ldc + c);
+        }
+    }
+}
+
+inline void Conv3x3s1Winograd43TransformOutputTile(const float* src,
+                                                   size_t src_stride,
+                                                   float* dst,
+                                                   size_t ow,
+                                                   size_t oc,
+                                                   size_t ldc,
+                                                   const Epilogue& epilogue,
+                                                   size_t row_end,
+                                                   size_t col_end) {
+    assert(oc >= 4);
+
+    size_t oc4 = oc / 4 * 4;
+
+    for (size_t c = 0; c < oc4; c += 4) {
+        Conv3x3s1Winograd43TransformOutput4t(src,
+                                             src_stride,
+                                             dst,
+                                             ow,
+                                             ldc,
+                                             epilogue,
+                                             row_end,
+                                             col_end,
+                                             c);
+    }
+
+    // overlap the last full vector
+    if (oc4 < oc) {
+        Conv3x3s1Winograd43TransformOutput4t(src,
+                                             src_stride,
+                                             dst,
+                                             ow,
+                                             ldc,
+                                             epilogue,
+                                             row_end,
+                                             col_end,
+                                             oc - 4);
+    }
+}
+
+void Conv3x3s1Winograd43TransformOutput(const float* src,
+                                        size_t src_stride,
+                                        float* dst,
+                                        size_t oh,
+                                        size_t ow,
+                                        size_t oc,
+                                        size_t ldc,
+                                        const Epilogue& epilogue,
+                                        size_t tile_stride,
+                                        size_t tile_begin,
+                                        size_t tile_end) {
+    const size_t tiles_w = (ow + 3) / 4;
+
+    src += tile_begin * tile_stride;
+
+    for (size_t tile = tile_begin; tile < tile_end; ++tile) {
+        const size_t row = tile / tiles_w * 4;
+        const size_t col = tile % tiles_w * 4;
+
+        const size_t row_end = (std::min)((size_t)4, oh - row);
+        const size_t col_end = (std::min)((size_t)4, ow - col);
+
+        Conv3x3s1Winograd43TransformOutputTile(
+            src,
+            src_stride,
+            dst + (row * ow + col) * ldc,
+            ow,
+            oc,
+            ldc,
+            epilogue.Offset(row * ow + col, 0),
+            row_end,
+            col_end);
+        src += tile_stride;
+    }
 }
 
 }  // namespace HWY_NAMESPACE
@@ -891,16 +1314,26 @@ void Conv3x3s1Winograd23TransformInput(const float* src,
                                        size_t ih,
                                        size_t iw,
                                        size_t ic,
-                                       bool pad,
+                                       size_t pad_t,
+                                       size_t pad_l,
+                                       size_t ow,
                                        float* dst,
-                                       size_t dst_stride) {
+                                       size_t dst_stride,
+                                       size_t tile_stride,
+                                       size_t tile_begin,
+                                       size_t tile_end) {
     return hn::Conv3x3s1Winograd23TransformInput<4>(src,
                                                     ih,
                                                     iw,
                                                     ic,
-                                                    pad,
+                                                    pad_t,
+                                                    pad_l,
+                                                    ow,
                                                     dst,
-                                                    dst_stride);
+                                                    dst_stride,
+                                                    tile_stride,
+                                                    tile_begin,
+                                                    tile_end);
 }
 
 void Conv3x3s1Winograd23TransformOutput(const float* src,
@@ -908,13 +1341,80 @@ void Conv3x3s1Winograd23TransformOutput(const float* src,
                                         float* dst,
                                         size_t oh,
                                         size_t ow,
-                                        size_t oc) {
+                                        size_t oc,
+                                        size_t ldc,
+                                        const Epilogue& epilogue,
+                                        size_t tile_stride,
+                                        size_t tile_begin,
+                                        size_t tile_end) {
     return hn::Conv3x3s1Winograd23TransformOutput<4>(src,
                                                      src_stride,
                                                      dst,
                                                      oh,
                                                      ow,
-                                                     oc);
+                                                     oc,
+                                                     ldc,
+                                                     epilogue,
+                                                     tile_stride,
+                                                     tile_begin,
+                                                     tile_end);
+}
+
+void Conv3x3s1Winograd43TransformKernelPack4(const float* src,
+                                             size_t ic,
+                                             size_t oc,
+                                             float* dst) {
+    return hn::Conv3x3s1Winograd43TransformKernelPack4(src, ic, oc, dst);
+}
+
+void Conv3x3s1Winograd43TransformInput(const float* src,
+                                       size_t ih,
+                                       size_t iw,
+                                       size_t ic,
+                                       size_t pad_t,
+                                       size_t pad_l,
+                                       size_t ow,
+                                       float* dst,
+                                       size_t dst_stride,
+                                       size_t tile_stride,
+                                       size_t tile_begin,
+                                       size_t tile_end) {
+    return hn::Conv3x3s1Winograd43TransformInput(src,
+                                                 ih,
+                                                 iw,
+                                                 ic,
+                                                 pad_t,
+                                                 pad_l,
+                                                 ow,
+                                                 dst,
+                                                 dst_stride,
+                                                 tile_stride,
+                                                 tile_begin,
+                                                 tile_end);
+}
+
+void Conv3x3s1Winograd43TransformOutput(const float* src,
+                                        size_t src_stride,
+                                        float* dst,
+                                        size_t oh,
+                                        size_t ow,
+                                        size_t oc,
+                                        size_t ldc,
+                                        const Epilogue& epilogue,
+                                        size_t tile_stride,
+                                        size_t tile_begin,
+                                        size_t tile_end) {
+    return hn::Conv3x3s1Winograd43TransformOutput(src,
+                                                  src_stride,
+                                                  dst,
+                                                  oh,
+                                                  ow,
+                                                  oc,
+                                                  ldc,
+                                                  epilogue,
+                                                  tile_stride,
+                                                  tile_begin,
+                                                  tile_end);
 }
 
 }  // namespace SimpleInfer
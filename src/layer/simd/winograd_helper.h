@@ -3,6 +3,8 @@
 
 #include <cstddef>
 
+#include "activation.h"
+
 namespace SimpleInfer {
 
 void Conv3x3s1Winograd23TransformKernelPack4(const float* src,
@@ -10,20 +12,69 @@ void Conv3x3s1Winograd23TransformKernelPack4(const float* src,
                                              size_t oc,
                                              float* dst);
 
+// src pixels are ic apart, tile t is stored at dst + t * tile_stride, so one
+// channel block of a wider buffer can be filled with ic < tile_stride. Only
+// tiles [tile_begin, tile_end) in row major order are transformed, so threads
+// can share an image. Zero padding is pad_t and pad_l on top and left, bottom
+// and right padding follow from ow and the tiles
 void Conv3x3s1Winograd23TransformInput(const float* src,
                                        size_t ih,
                                        size_t iw,
                                        size_t ic,
-                                       bool pad,
+                                       size_t pad_t,
+                                       size_t pad_l,
+                                       size_t ow,
                                        float* dst,
-                                       size_t dst_stride);
+                                       size_t dst_stride,
+                                       size_t tile_stride,
+                                       size_t tile_begin,
+                                       size_t tile_end);
 
+// epilogue is applied per tile before it is stored, tile t is read from
+// src + t * tile_stride
 void Conv3x3s1Winograd23TransformOutput(const float* src,
                                         size_t src_stride,
                                         float* dst,
                                         size_t oh,
                                         size_t ow,
-                                        size_t oc);
+                                        size_t oc,
+                                        size_t ldc,
+                                        const Epilogue& epilogue,
+                                        size_t tile_stride,
+                                        size_t tile_begin,
+                                        size_t tile_end);
+
+// F(4x4,3x3), 6x6 tiles in 36 gemms. Same buffers and strides as above, ic
+// and oc of a call must be at least 4
+void Conv3x3s1Winograd43TransformKernelPack4(const float* src,
+                                             size_t ic,
+                                             size_t oc,
+                                             float* dst);
+
+void Conv3x3s1Winograd43TransformInput(const float* src,
+                                       size_t ih,
+                                       size_t iw,
+                                       size_t ic,
+                                       size_t pad_t,
+                                       size_t pad_l,
+                                       size_t ow,
+                                       float* dst,
+                                       size_t dst_stride,
+                                       size_t tile_stride,
+                                       size_t tile_begin,
+                                       size_t tile_end);
+
+void Conv3x3s1Winograd43TransformOutput(const float* src,
+                                        size_t src_stride,
+                                        float* dst,
+                                        size_t oh,
+                                        size_t ow,
+                                        size_t oc,
+                                        size_t ldc,
+                                        const Epilogue& epilogue,
+                                        size_t tile_stride,
+                                        size_t tile_begin,
+                                        size_t tile_end);
 
 }  // namespace SimpleInfer
 
@@ -73,6 +73,11 @@ Status Upsample::Validate() {
     return Status::kSuccess;
 }
 
+bool Upsample::SupportLayout(const Layout) const {
+    // copies whole pixels, order of channels inside does not matter
+    return true;
+}
+
 struct Nearest4D {
     Nearest4D(const EigenTensorMap<float, 4>& _input,
               float _scale_h_inv,
@@ -19,12 +19,14 @@ DECLARE_LAYER_REGISTRY(BatchNorm2d)
 DECLARE_LAYER_REGISTRY(BinaryOp)
 DECLARE_LAYER_REGISTRY(Cat)
 DECLARE_LAYER_REGISTRY(Conv2d)
+DECLARE_LAYER_REGISTRY(Expression)
 DECLARE_LAYER_REGISTRY(Flatten)
 DECLARE_LAYER_REGISTRY(HardSigmoid)
 DECLARE_LAYER_REGISTRY(HardSwish)
 DECLARE_LAYER_REGISTRY(Linear)
 DECLARE_LAYER_REGISTRY(MaxPool2d)
 DECLARE_LAYER_REGISTRY(ReLU)
+DECLARE_LAYER_REGISTRY(Reorder)
 DECLARE_LAYER_REGISTRY(Sigmoid)
 DECLARE_LAYER_REGISTRY(SiLU)
 DECLARE_LAYER_REGISTRY(Upsample)
@@ -36,12 +38,14 @@ static std::map<std::string, LayerRegistryEntry> layer_registry_map = {
     LAYER_REGISTRY_ITEM(BinaryOp, BinaryOp),
     LAYER_REGISTRY_ITEM(torch.cat, Cat),
     LAYER_REGISTRY_ITEM(nn.Conv2d, Conv2d),
+    LAYER_REGISTRY_ITEM(pnnx.Expression, Expression),
     LAYER_REGISTRY_ITEM(torch.flatten, Flatten),
     LAYER_REGISTRY_ITEM(nn.Hardsigmoid, HardSigmoid),
     LAYER_REGISTRY_ITEM(nn.Hardswish, HardSwish),
     LAYER_REGISTRY_ITEM(nn.Linear, Linear),
     LAYER_REGISTRY_ITEM(nn.MaxPool2d, MaxPool2d),
     LAYER_REGISTRY_ITEM(nn.ReLU, ReLU),
+    LAYER_REGISTRY_ITEM(Reorder, Reorder),
     LAYER_REGISTRY_ITEM(nn.Sigmoid, Sigmoid),
     LAYER_REGISTRY_ITEM(nn.SiLU, SiLU),
     LAYER_REGISTRY_ITEM(nn.Upsample, Upsample),
@@ -0,0 +1,203 @@
+#include "layout_planner.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace SimpleInfer {
+
+// larger than any cut, which is at most one per tensor
+static const int kInfinity = 1 << 29;
+
+LayoutPlanner::LayoutPlanner() {}
+
+LayoutPlanner::~LayoutPlanner() {}
+
+void LayoutPlanner::SetChoice(const pnnx::Operator* op, const Choice choice) {
+    choices_[op] = choice;
+}
+
+void LayoutPlanner::AddTensor(const std::string& name) {
+    tensors_.insert(name);
+}
+
+Status LayoutPlanner::Plan(const pnnx::Graph* graph) {
+    if (nullptr == graph) {
+        return Status::kEmpty;
+    }
+
+    edges_.clear();
+    adjacency_.clear();
+    blocked_.clear();
+
+    reorder_count_ = 0;
+
+    // source side is NHWC, sink side blocked
+    const int source = AddNode();
+    const int sink   = AddNode();
+
+    std::map<const pnnx::Operator*, int> nodes;
+    for (const pnnx::Operator* op : graph->ops) {
+        const int node = AddNode();
+        nodes[op]      = node;
+
+        Choice choice = Choice::kFree;
+        if (choices_.count(op) > 0) {
+            choice = choices_.at(op);
+        } else if ("pnnx.Input" == op->type || "pnnx.Output" == op->type) {
+            choice = Choice::kNHWC;
+        }
+
+        if (Choice::kNHWC == choice) {
+            AddEdge(source, node, kInfinity);
+        } else if (Choice::kBlocked == choice) {
+            AddEdge(node, sink, kInfinity);
+        }
+    }
+
+    std::vector<std::vector<int>> tensor_nodes;
+    for (const pnnx::Operand* operand : graph->operands) {
+        if (tensors_.count(operand->name) <= 0 ||
+            nullptr == operand->producer) {
+            continue;
+        }
+
+        std::vector<int> members{nodes.at(operand->producer)};
+        for (const pnnx::Operator* consumer : operand->consumers) {
+            members.push_back(nodes.at(consumer));
+        }
+
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(), members.end()),
+                      members.end());
+
+        if (members.size() < 2) {
+            continue;
+        }
+
+        // cost 1 unless all members agree: max(members) - min(members),
+        // upper is 1 when any member is blocked, lower 0 when any is NHWC
+        const int upper = AddNode();
+        const int lower = AddNode();
+
+        AddEdge(source, upper, 1);
+        AddEdge(lower, sink, 1);
+
+        for (const int member : members) {
+            AddEdge(upper, member, kInfinity);
+            AddEdge(member, lower, kInfinity);
+        }
+
+        tensor_nodes.push_back(members);
+    }
+
+    MaxFlow(source, sink);
+
+    // nodes still reachable from source are on the NHWC side of the cut
+    std::vector<bool> reachable(adjacency_.size(), false);
+    std::deque<int> queue{source};
+    reachable[source] = true;
+    while (!queue.empty()) {
+        const int node = queue.front();
+        queue.pop_front();
+
+        for (const int e : adjacency_[node]) {
+            const Edge& edge = edges_[e];
+            if (edge.capacity > 0 && !reachable[edge.to]) {
+                reachable[edge.to] = true;
+                queue.push_back(edge.to);
+            }
+        }
+    }
+
+    for (const auto& node_iter : nodes) {
+        if (!reachable[node_iter.second]) {
+            blocked_.insert(node_iter.first);
+        }
+    }
+
+    for (const std::vector<int>& members : tensor_nodes) {
+        const bool blocked = !reachable[members[0]];
+        for (const int member : members) {
+            if (blocked == reachable[member]) {
+                ++reorder_count_;
+                break;
+            }
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+bool LayoutPlanner::IsBlocked(const pnnx::Operator* op) const {
+    return (blocked_.count(op) > 0);
+}
+
+int LayoutPlanner::GetReorderCount() const {
+    return reorder_count_;
+}
+
+int LayoutPlanner::AddNode() {
+    adjacency_.emplace_back();
+
+    return (int)adjacency_.size() - 1;
+}
+
+void LayoutPlanner::AddEdge(int from, int to, int capacity) {
+    Edge edge;
+    edge.to       = to;
+    edge.capacity = capacity;
+
+    adjacency_[from].push_back((int)edges_.size());
+    edges_.push_back(edge);
+
+    Edge reverse;
+    reverse.to       = from;
+    reverse.capacity = 0;
+
+    adjacency_[to].push_back((int)edges_.size());
+    edges_.push_back(reverse);
+}
+
+void LayoutPlanner::MaxFlow(int source, int sink) {
+    const int num_nodes = (int)adjacency_.size();
+
+    while (true) {
+        // edge into each node on a shortest augmenting path
+        std::vector<int> parent(num_nodes, -1);
+        std::deque<int> queue{source};
+        parent[source] = -2;
+
+        while (!queue.empty() && parent[sink] < 0) {
+            const int node = queue.front();
+            queue.pop_front();
+
+            for (const int e : adjacency_[node]) {
+                const Edge& edge = edges_[e];
+                if (edge.capacity > 0 && -1 == parent[edge.to]) {
+                    parent[edge.to] = e;
+                    queue.push_back(edge.to);
+                }
+            }
+        }
+
+        if (parent[sink] < 0) {
+            break;
+        }
+
+        int flow = kInfinity;
+        for (int node = sink; node != source;) {
+            const int e = parent[node];
+            flow        = (std::min)(flow, edges_[e].capacity);
+            node        = edges_[e ^ 1].to;
+        }
+
+        for (int node = sink; node != source;) {
+            const int e = parent[node];
+            edges_[e].capacity -= flow;
+            edges_[e ^ 1].capacity += flow;
+            node = edges_[e ^ 1].to;
+        }
+    }
+}
+
+}  // namespace SimpleInfer
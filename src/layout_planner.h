@@ -0,0 +1,73 @@
+#ifndef SIMPLE_INFER_SRC_LAYOUT_PLANNER_H_
+#define SIMPLE_INFER_SRC_LAYOUT_PLANNER_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "pnnx/ir.h"
+#include "types.h"
+
+namespace SimpleInfer {
+
+// Choose between NHWC and one blocked layout for every operator, so that the
+// fewest tensors need a reorder.
+//
+// An operator is pinned to NHWC, e.g. a layer without blocked support or a
+// graph input or output, pinned to the blocked layout, e.g. a layer which
+// runs faster in it, or free. A tensor writes and reads in the layout of its
+// producer and needs one reorder when any consumer disagrees, which makes the
+// choice a minimum cut with one hyperedge per tensor.
+class LayoutPlanner {
+public:
+    enum class Choice { kFree = 0, kNHWC, kBlocked };
+
+public:
+    LayoutPlanner();
+
+    ~LayoutPlanner();
+
+public:
+    // pnnx.Input and pnnx.Output are NHWC unless set
+    void SetChoice(const pnnx::Operator* op, const Choice choice);
+
+    // operand [name] has a layout, other operands stay NHWC and never count
+    void AddTensor(const std::string& name);
+
+    Status Plan(const pnnx::Graph* graph);
+
+    bool IsBlocked(const pnnx::Operator* op) const;
+
+    // tensors whose producer and consumers are in different layouts
+    int GetReorderCount() const;
+
+protected:
+    int AddNode();
+
+    void AddEdge(int from, int to, int capacity);
+
+    // augment along shortest paths until the sink is cut off
+    void MaxFlow(int source, int sink);
+
+protected:
+    struct Edge {
+        int to       = 0;
+        int capacity = 0;
+    };
+
+    std::map<const pnnx::Operator*, Choice> choices_;
+    std::set<std::string> tensors_;
+
+    // residual graph, edge e ^ 1 is the reverse of edge e
+    std::vector<Edge> edges_;
+    std::vector<std::vector<int>> adjacency_;
+
+    std::set<const pnnx::Operator*> blocked_;
+
+    int reorder_count_ = 0;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_LAYOUT_PLANNER_H_
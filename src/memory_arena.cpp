@@ -0,0 +1,89 @@
+#include "memory_arena.h"
+
+#include <cstdlib>
+
+#include "logger.h"
+
+namespace SimpleInfer {
+
+void* AlignedMalloc(size_t size, size_t alignment) {
+    if (0 == size) {
+        return nullptr;
+    }
+
+#if defined(_MSC_VER)
+    return _aligned_malloc(size, alignment);
+#else
+    void* data = nullptr;
+    if (0 != posix_memalign(&data, alignment, size)) {
+        return nullptr;
+    }
+
+    return data;
+#endif
+}
+
+void AlignedFree(void* data) {
+#if defined(_MSC_VER)
+    _aligned_free(data);
+#else
+    free(data);
+#endif
+}
+
+MemoryArena::MemoryArena() {}
+
+MemoryArena::~MemoryArena() {
+    Release();
+}
+
+Status MemoryArena::Reserve(size_t size) {
+    if (size <= size_ && nullptr != storage_ && !IsShared()) {
+        return Status::kSuccess;
+    }
+
+    Release();
+
+    if (0 == size) {
+        return Status::kSuccess;
+    }
+
+    void* data = AlignedMalloc(size);
+    if (nullptr == data) {
+        LOG(ERROR) << "MemoryArena Reserve Fail, size " << size;
+        return Status::kFail;
+    }
+
+    storage_.reset(data, AlignedFree);
+    size_ = size;
+
+    return Status::kSuccess;
+}
+
+void MemoryArena::Release() {
+    storage_.reset();
+
+    size_ = 0;
+}
+
+void* MemoryArena::Data(size_t offset) const {
+    if (nullptr == storage_) {
+        return nullptr;
+    }
+
+    return static_cast<char*>(storage_.get()) + offset;
+}
+
+size_t MemoryArena::Size() const {
+    return size_;
+}
+
+const std::shared_ptr<void>& MemoryArena::Storage() const {
+    return storage_;
+}
+
+bool MemoryArena::IsShared() const {
+    return (storage_.use_count() > 1);
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,53 @@
+#ifndef SIMPLE_INFER_SRC_MEMORY_ARENA_H_
+#define SIMPLE_INFER_SRC_MEMORY_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "types.h"
+
+namespace SimpleInfer {
+
+// cache line, also wide enough for any simd register
+static const size_t kMemoryAlignment = 64;
+
+void* AlignedMalloc(size_t size, size_t alignment = kMemoryAlignment);
+
+void AlignedFree(void* data);
+
+// One aligned block of memory, sub-views are handed out by offset. The block
+// is ref-counted, tensors sharing it keep it alive after Release().
+class MemoryArena {
+public:
+    MemoryArena();
+
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+public:
+    // keep the old block if it is large enough and not shared
+    Status Reserve(size_t size);
+
+    void Release();
+
+    // nullptr while nothing is reserved
+    void* Data(size_t offset = 0) const;
+
+    size_t Size() const;
+
+    const std::shared_ptr<void>& Storage() const;
+
+    // block is still referenced outside the arena
+    bool IsShared() const;
+
+protected:
+    std::shared_ptr<void> storage_;
+    size_t size_ = 0;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_MEMORY_ARENA_H_
@@ -0,0 +1,376 @@
+#include "memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "logger.h"
+
+namespace SimpleInfer {
+
+static size_t AlignSize(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static size_t OperandSize(const pnnx::Operand* operand) {
+    size_t size = ElementSize(PnnxToDataType(operand->type));
+    for (const auto s : operand->shape) {
+        size *= (size_t)(std::max)(s, 0);
+    }
+
+    return size;
+}
+
+MemoryPlanner::MemoryPlanner() {}
+
+MemoryPlanner::~MemoryPlanner() {}
+
+void MemoryPlanner::SetAlias(const std::string& name,
+                             const std::string& target,
+                             size_t offset) {
+    AliasInfo alias;
+    alias.target = target;
+    alias.offset = offset;
+
+    aliases_[name] = alias;
+}
+
+void MemoryPlanner::SetSize(const std::string& name, size_t size) {
+    sizes_[name] = size;
+}
+
+Status MemoryPlanner::Plan(const pnnx::Graph* graph) {
+    if (nullptr == graph) {
+        return Status::kEmpty;
+    }
+
+    execution_order_.clear();
+    execution_index_.clear();
+    reachability_.clear();
+    tensors_.clear();
+    tensor_index_.clear();
+    offsets_.clear();
+    pinned_roots_.clear();
+    pinned_sizes_.clear();
+
+    peak_size_  = 0;
+    naive_size_ = 0;
+
+    CHECK_STATUS(CreateExecutionOrder(graph));
+
+    CreateReachability();
+
+    for (const pnnx::Operand* operand : graph->operands) {
+        const pnnx::Operator* producer = operand->producer;
+        if (nullptr == producer || "pnnx.Input" == producer->type ||
+            "pnnx.Attribute" == producer->type) {
+            // input tensor use external memory, constant its own
+            continue;
+        }
+
+        TensorInfo tensor;
+        tensor.operand   = operand;
+        tensor.size      = (sizes_.count(operand->name) > 0)
+                               ? sizes_.at(operand->name)
+                               : OperandSize(operand);
+        tensor.first_use = execution_index_.at(producer);
+        tensor.last_use  = tensor.first_use;
+        tensor.writers.push_back(tensor.first_use);
+        tensor.readers.push_back(tensor.first_use);
+
+        for (const pnnx::Operator* consumer : operand->consumers) {
+            if ("pnnx.Output" == consumer->type) {
+                // user may extract it after forward
+                tensor.pinned = true;
+                continue;
+            }
+
+            const int index = execution_index_.at(consumer);
+            tensor.readers.push_back(index);
+            tensor.last_use = (std::max)(tensor.last_use, index);
+        }
+
+        naive_size_ += AlignSize(tensor.size, kAlignment);
+
+        tensor_index_[operand->name] = tensors_.size();
+        tensors_.push_back(tensor);
+    }
+
+    CHECK_STATUS(MergeAliases());
+
+    AssignOffsets();
+
+    for (const auto& tensor : tensors_) {
+        const std::string& name = tensor.operand->name;
+
+        std::string root;
+        size_t offset = 0;
+        CHECK_STATUS(ResolveAlias(name, root, offset));
+
+        const TensorInfo& root_tensor = tensors_[tensor_index_.at(root)];
+        if (root_tensor.pinned) {
+            pinned_roots_[name] = root;
+            pinned_sizes_[root] = root_tensor.size;
+            offsets_[name]      = offset;
+        } else {
+            offsets_[name] = root_tensor.offset + offset;
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+bool MemoryPlanner::HasOffset(const std::string& name) const {
+    return (offsets_.count(name) > 0);
+}
+
+size_t MemoryPlanner::GetOffset(const std::string& name) const {
+    return offsets_.at(name);
+}
+
+bool MemoryPlanner::IsPinned(const std::string& name) const {
+    return (pinned_roots_.count(name) > 0);
+}
+
+const std::string& MemoryPlanner::GetPinnedRoot(const std::string& name) const {
+    return pinned_roots_.at(name);
+}
+
+const std::map<std::string, size_t>& MemoryPlanner::GetPinnedSizes() const {
+    return pinned_sizes_;
+}
+
+size_t MemoryPlanner::GetPeakSize() const {
+    return peak_size_;
+}
+
+size_t MemoryPlanner::GetNaiveSize() const {
+    return naive_size_;
+}
+
+const std::vector<const pnnx::Operator*>& MemoryPlanner::GetExecutionOrder()
+    const {
+    return execution_order_;
+}
+
+Status MemoryPlanner::CreateExecutionOrder(const pnnx::Graph* graph) {
+    const int num_ops = (int)graph->ops.size();
+
+    // keep the graph order when it is already topological
+    std::vector<bool> visited(num_ops, false);
+
+    while ((int)execution_order_.size() < num_ops) {
+        bool progress = false;
+
+        for (int i = 0; i < num_ops; ++i) {
+            if (visited[i]) {
+                continue;
+            }
+
+            const pnnx::Operator* op = graph->ops[i];
+
+            bool ready = true;
+            for (const pnnx::Operand* input : op->inputs) {
+                if (nullptr != input->producer &&
+                    execution_index_.count(input->producer) <= 0) {
+                    ready = false;
+                    break;
+                }
+            }
+
+            if (!ready) {
+                continue;
+            }
+
+            visited[i] = true;
+
+            execution_index_[op] = (int)execution_order_.size();
+            execution_order_.push_back(op);
+
+            progress = true;
+        }
+
+        if (!progress) {
+            LOG(ERROR) << "MemoryPlanner fail [graph has cycle]";
+            return Status::kFail;
+        }
+    }
+
+    return Status::kSuccess;
+}
+
+Status MemoryPlanner::ResolveAlias(const std::string& name,
+                                   std::string& root,
+                                   size_t& offset) const {
+    root   = name;
+    offset = 0;
+
+    // the chain can not be longer than the number of aliases
+    for (size_t i = 0; i <= aliases_.size(); ++i) {
+        auto alias_iter = aliases_.find(root);
+        if (aliases_.end() == alias_iter) {
+            if (tensor_index_.count(root) <= 0) {
+                LOG(ERROR) << "MemoryPlanner fail [alias target " << root
+                           << " not planned]";
+                return Status::kFail;
+            }
+
+            return Status::kSuccess;
+        }
+
+        root = alias_iter->second.target;
+        offset += alias_iter->second.offset;
+    }
+
+    LOG(ERROR) << "MemoryPlanner fail [alias of " << name << " has cycle]";
+
+    return Status::kFail;
+}
+
+Status MemoryPlanner::MergeAliases() {
+    for (const auto& alias_iter : aliases_) {
+        const std::string& name = alias_iter.first;
+        if (tensor_index_.count(name) <= 0) {
+            LOG(ERROR) << "MemoryPlanner fail [alias " << name
+                       << " not planned]";
+            return Status::kFail;
+        }
+
+        std::string root;
+        size_t offset = 0;
+        CHECK_STATUS(ResolveAlias(name, root, offset));
+
+        TensorInfo& tensor      = tensors_[tensor_index_.at(name)];
+        TensorInfo& root_tensor = tensors_[tensor_index_.at(root)];
+
+        root_tensor.size = (std::max)(root_tensor.size, offset + tensor.size);
+
+        root_tensor.pinned = root_tensor.pinned || tensor.pinned;
+
+        root_tensor.first_use =
+            (std::min)(root_tensor.first_use, tensor.first_use);
+        root_tensor.last_use =
+            (std::max)(root_tensor.last_use, tensor.last_use);
+
+        root_tensor.writers.insert(root_tensor.writers.end(),
+                                   tensor.writers.begin(),
+                                   tensor.writers.end());
+        root_tensor.readers.insert(root_tensor.readers.end(),
+                                   tensor.readers.begin(),
+                                   tensor.readers.end());
+
+        tensor.merged = true;
+    }
+
+    return Status::kSuccess;
+}
+
+void MemoryPlanner::CreateReachability() {
+    const int num_ops = (int)execution_order_.size();
+
+    reachability_.assign(num_ops, std::vector<bool>(num_ops, false));
+
+    for (int i = num_ops - 1; i >= 0; --i) {
+        std::vector<bool>& reach = reachability_[i];
+
+        for (const pnnx::Operand* output : execution_order_[i]->outputs) {
+            for (const pnnx::Operator* consumer : output->consumers) {
+                const int index = execution_index_.at(consumer);
+
+                reach[index] = true;
+
+                const std::vector<bool>& consumer_reach = reachability_[index];
+                for (int j = index + 1; j < num_ops; ++j) {
+                    if (consumer_reach[j]) {
+                        reach[j] = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool MemoryPlanner::IsDeadBefore(const TensorInfo& tensor0,
+                                 const TensorInfo& tensor1) const {
+    for (const int reader : tensor0.readers) {
+        for (const int writer : tensor1.writers) {
+            if (reader == writer || !reachability_[reader][writer]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool MemoryPlanner::IsConflict(const TensorInfo& tensor0,
+                               const TensorInfo& tensor1) const {
+    return !(IsDeadBefore(tensor0, tensor1) || IsDeadBefore(tensor1, tensor0));
+}
+
+void MemoryPlanner::AssignOffsets() {
+    // greedy by size, larger tensors first
+    std::vector<int> order;
+    for (size_t i = 0; i < tensors_.size(); ++i) {
+        if (!tensors_[i].merged && !tensors_[i].pinned) {
+            order.push_back((int)i);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        if (tensors_[a].size != tensors_[b].size) {
+            return tensors_[a].size > tensors_[b].size;
+        }
+
+        return tensors_[a].first_use < tensors_[b].first_use;
+    });
+
+    std::vector<int> assigned;
+    for (const int index : order) {
+        TensorInfo& tensor = tensors_[index];
+
+        std::vector<const TensorInfo*> conflicts;
+        for (const int other : assigned) {
+            if (IsConflict(tensor, tensors_[other])) {
+                conflicts.push_back(&tensors_[other]);
+            }
+        }
+
+        std::sort(conflicts.begin(),
+                  conflicts.end(),
+                  [](const TensorInfo* a, const TensorInfo* b) {
+                      return a->offset < b->offset;
+                  });
+
+        // best fit gap between conflicting tensors
+        size_t best_offset = std::numeric_limits<size_t>::max();
+        size_t best_gap    = std::numeric_limits<size_t>::max();
+        size_t gap_begin   = 0;
+        for (const TensorInfo* conflict : conflicts) {
+            if (conflict->offset > gap_begin) {
+                const size_t gap = conflict->offset - gap_begin;
+                if (gap >= tensor.size && gap < best_gap) {
+                    best_gap    = gap;
+                    best_offset = gap_begin;
+                }
+            }
+
+            gap_begin = (std::max)(
+                gap_begin,
+                AlignSize(conflict->offset + conflict->size, kAlignment));
+        }
+
+        if (std::numeric_limits<size_t>::max() == best_offset) {
+            best_offset = gap_begin;
+        }
+
+        tensor.offset = best_offset;
+
+        const size_t tensor_end =
+            AlignSize(tensor.offset + tensor.size, kAlignment);
+        peak_size_ = (std::max)(peak_size_, tensor_end);
+
+        assigned.push_back(index);
+    }
+}
+
+}  // namespace SimpleInfer
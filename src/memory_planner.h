@@ -0,0 +1,138 @@
+#ifndef SIMPLE_INFER_SRC_MEMORY_PLANNER_H_
+#define SIMPLE_INFER_SRC_MEMORY_PLANNER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "memory_arena.h"
+#include "pnnx/ir.h"
+#include "types.h"
+
+namespace SimpleInfer {
+
+// Assign every intermediate operand an offset inside one shared buffer, so
+// that operands whose lifetimes never overlap reuse the same bytes.
+//
+// Lifetimes come from the pnnx producer/consumer lists. Since the pipeline may
+// run independent branches concurrently, two operands only share memory when
+// every reader of one is an ancestor of the producer of the other, not merely
+// earlier in the execution order.
+//
+// Aliased operands (in-place layers, views) are merged into their root
+// operand, which then carries the lifetimes of all of them.
+//
+// Roots read by pnnx.Output are pinned. They stay out of the shared buffer
+// and get a block each, so the caller may hold them across runs.
+class MemoryPlanner {
+public:
+    MemoryPlanner();
+
+    ~MemoryPlanner();
+
+public:
+    // operand [name] lives inside operand [target] at byte offset
+    void SetAlias(const std::string& name,
+                  const std::string& target,
+                  size_t offset = 0);
+
+    // bytes of operand [name] when it differs from its pnnx shape, e.g. a
+    // blocked layout with padded channels
+    void SetSize(const std::string& name, size_t size);
+
+    Status Plan(const pnnx::Graph* graph);
+
+    bool HasOffset(const std::string& name) const;
+
+    // inside the shared buffer, or inside the block of a pinned root
+    size_t GetOffset(const std::string& name) const;
+
+    bool IsPinned(const std::string& name) const;
+
+    // root operand owning the block of a pinned operand
+    const std::string& GetPinnedRoot(const std::string& name) const;
+
+    // bytes of each pinned block, by root
+    const std::map<std::string, size_t>& GetPinnedSizes() const;
+
+    size_t GetPeakSize() const;
+
+    size_t GetNaiveSize() const;
+
+    const std::vector<const pnnx::Operator*>& GetExecutionOrder() const;
+
+public:
+    static const size_t kAlignment = kMemoryAlignment;
+
+protected:
+    struct TensorInfo {
+        const pnnx::Operand* operand = nullptr;
+
+        size_t size   = 0;
+        size_t offset = 0;
+
+        // own block outside the shared buffer, e.g. graph outputs
+        bool pinned = false;
+
+        // lives inside its alias root, not assigned itself
+        bool merged = false;
+
+        // execution index of first producer and last consumer
+        int first_use = 0;
+        int last_use  = 0;
+
+        std::vector<int> writers;
+        std::vector<int> readers;
+    };
+
+    struct AliasInfo {
+        std::string target;
+        size_t offset = 0;
+    };
+
+    Status CreateExecutionOrder(const pnnx::Graph* graph);
+
+    // follow alias chain to the operand which owns memory
+    Status ResolveAlias(const std::string& name,
+                        std::string& root,
+                        size_t& offset) const;
+
+    Status MergeAliases();
+
+    void CreateReachability();
+
+    // all readers of tensor0 finish before any writer of tensor1 starts
+    bool IsDeadBefore(const TensorInfo& tensor0,
+                      const TensorInfo& tensor1) const;
+
+    bool IsConflict(const TensorInfo& tensor0,
+                    const TensorInfo& tensor1) const;
+
+    void AssignOffsets();
+
+protected:
+    std::vector<const pnnx::Operator*> execution_order_;
+    std::map<const pnnx::Operator*, int> execution_index_;
+
+    // reachability_[i][j] is true if op j depends on op i
+    std::vector<std::vector<bool>> reachability_;
+
+    std::map<std::string, AliasInfo> aliases_;
+
+    std::map<std::string, size_t> sizes_;
+
+    std::vector<TensorInfo> tensors_;
+    std::map<std::string, size_t> tensor_index_;
+
+    std::map<std::string, size_t> offsets_;
+
+    std::map<std::string, std::string> pinned_roots_;
+    std::map<std::string, size_t> pinned_sizes_;
+
+    size_t peak_size_  = 0;
+    size_t naive_size_ = 0;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_MEMORY_PLANNER_H_
@@ -6,13 +6,18 @@ void PipelineNode::SetLayer(Layer* layer) {
     layer_ = layer;
 }
 
+void PipelineNode::SetProfiler(Profiler* profiler) {
+    profiler_ = profiler;
+}
+
 CStatus PipelineNode::run() {
     if (nullptr == layer_) {
         return CStatus("empty layer");
     }
 
     {
-        Status ret = layer_->Forward();
+        Status ret = (nullptr == profiler_) ? layer_->Forward()
+                                            : profiler_->Forward(layer_);
         if (Status::kSuccess != ret) {
             LOG(ERROR) << "layer [" << layer_->GetOp()->name
                        << "] forward fail";
@@ -5,6 +5,7 @@
 
 #include "layer.h"
 #include "logger.h"
+#include "profiler.h"
 
 namespace SimpleInfer {
 
@@ -12,10 +13,15 @@ class PipelineNode : public CGraph::GNode {
 public:
     void SetLayer(Layer* layer);
 
+    // nullptr for no profiling
+    void SetProfiler(Profiler* profiler);
+
     virtual CStatus run() override;
 
 protected:
     Layer* layer_ = nullptr;
+
+    Profiler* profiler_ = nullptr;
 };
 
 }  // namespace SimpleInfer
@@ -307,6 +307,11 @@ static std::string expand_expression(Graph& graph, const Operator* op, int& pnnx
 }
 
 void expand_expression(Graph& graph)
+{
+    expand_expression(graph, 0);
+}
+
+void expand_expression(Graph& graph, bool (*keep)(const Operator* op))
 {
     int pnnx_expr_index = 0;
 
@@ -325,6 +330,9 @@ void expand_expression(Graph& graph)
             if (nonsupported_expr_ops.find(op) != nonsupported_expr_ops.end())
                 continue;
 
+            if (keep && keep(op))
+                continue;
+
             matched = true;
 
             std::string outname = expand_expression(graph, op, pnnx_expr_index);
@@ -375,6 +383,9 @@ void expand_expression(Graph& graph)
             graph.ops.erase(std::find(graph.ops.begin(), graph.ops.end(), op));
             delete op;
 
+            // keep the name, it may be a graph output looked up by name
+            new_output_operand->name = old_output_operand->name;
+
             graph.operands.erase(std::find(graph.operands.begin(), graph.operands.end(), old_output_operand));
             delete old_output_operand;
 
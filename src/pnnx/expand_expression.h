@@ -19,4 +19,7 @@ namespace pnnx {
 
 void expand_expression(Graph& graph);
 
+// expressions accepted by keep stay one pnnx.Expression operator
+void expand_expression(Graph& graph, bool (*keep)(const Operator* op));
+
 } // namespace pnnx
@@ -1,5 +1,9 @@
 #include "pnnx_helper.h"
 
+#include <cstring>
+
+#include "logger.h"
+
 namespace SimpleInfer {
 
 bool CheckParam(const std::map<std::string, pnnx::Parameter>& params,
@@ -38,4 +42,148 @@ bool CheckAttr(const pnnx::Operator* op,
     return CheckAttr(op->attrs, name, type);
 }
 
+std::vector<int> PnnxToNHWCShape(const std::vector<int>& shape) {
+    std::vector<int> shape_nhwc = shape;
+    if (shape_nhwc.size() > 3) {
+        int shape_dims             = (int)shape_nhwc.size();
+        shape_nhwc[shape_dims - 1] = shape[shape_dims - 3];
+        shape_nhwc[shape_dims - 2] = shape[shape_dims - 1];
+        shape_nhwc[shape_dims - 3] = shape[shape_dims - 2];
+    }
+
+    return shape_nhwc;
+}
+
+const pnnx::Attribute* GetConstantAttr(const pnnx::Operator* op) {
+    if ("pnnx.Attribute" != op->type || op->attrs.empty()) {
+        return nullptr;
+    }
+
+    if (1 == op->attrs.size()) {
+        // attr name follows the operand, e.g. "data"
+        return &op->attrs.begin()->second;
+    }
+
+    auto attr_iter = op->attrs.find("data");
+    if (op->attrs.end() == attr_iter) {
+        return nullptr;
+    }
+
+    return &attr_iter->second;
+}
+
+// [outer, rows, cols] -> [outer, cols, rows] of element_size bytes each
+static void TransposeLastTwo(const char* src,
+                             char* dst,
+                             size_t element_size,
+                             size_t outer,
+                             size_t rows,
+                             size_t cols) {
+    for (size_t o = 0; o < outer; ++o) {
+        for (size_t r = 0; r < rows; ++r) {
+            for (size_t c = 0; c < cols; ++c) {
+                std::memcpy(dst + (c * rows + r) * element_size,
+                            src + (r * cols + c) * element_size,
+                            element_size);
+            }
+        }
+
+        src += rows * cols * element_size;
+        dst += rows * cols * element_size;
+    }
+}
+
+// pnnx [outer, c, h, w] is [outer, c, h * w], tensor is [outer, h * w, c]
+static void GetChannelDims(const std::vector<int>& shape,
+                           size_t& outer,
+                           size_t& channel,
+                           size_t& spatial) {
+    const size_t dims = shape.size();
+
+    outer   = 1;
+    channel = 1;
+    spatial = 1;
+
+    for (size_t i = 0; i < dims; ++i) {
+        if (dims <= 3 || i + 3 < dims) {
+            outer *= (size_t)shape[i];
+        } else if (i + 3 == dims) {
+            channel = (size_t)shape[i];
+        } else {
+            spatial *= (size_t)shape[i];
+        }
+    }
+}
+
+Status AttributeToTensor(const pnnx::Attribute& attr, Tensor& tensor) {
+    const DataType data_type  = PnnxToDataType(attr.type);
+    const size_t element_size = (size_t)ElementSize(data_type);
+    if (0 == element_size) {
+        LOG(ERROR) << "attribute type [" << attr.type << "] not supported";
+        return Status::kUnsupport;
+    }
+
+    size_t outer   = 0;
+    size_t channel = 0;
+    size_t spatial = 0;
+    GetChannelDims(attr.shape, outer, channel, spatial);
+
+    const size_t size = outer * channel * spatial;
+    if (attr.data.size() != size * element_size) {
+        LOG(ERROR) << "attribute data size [" << attr.data.size()
+                   << "] mismatch shape";
+        return Status::kFail;
+    }
+
+    tensor = Tensor(data_type, PnnxToNHWCShape(attr.shape), true);
+    if (size > 0 && nullptr == tensor.Data()) {
+        LOG(ERROR) << "attribute tensor allocate fail";
+        return Status::kFail;
+    }
+
+    TransposeLastTwo(attr.data.data(),
+                     static_cast<char*>(tensor.Data()),
+                     element_size,
+                     outer,
+                     channel,
+                     spatial);
+
+    return Status::kSuccess;
+}
+
+Status TensorToAttribute(const Tensor& tensor, pnnx::Attribute& attr) {
+    if (!IsSameDataType<float>(tensor.GetDataType()) ||
+        !tensor.IsContiguous()) {
+        LOG(ERROR) << "tensor is not contiguous f32";
+        return Status::kUnsupport;
+    }
+
+    // NHWC -> NCHW
+    std::vector<int> shape = tensor.Shape();
+    if (shape.size() > 3) {
+        int shape_dims        = (int)shape.size();
+        shape[shape_dims - 3] = tensor.Shape()[shape_dims - 1];
+        shape[shape_dims - 2] = tensor.Shape()[shape_dims - 3];
+        shape[shape_dims - 1] = tensor.Shape()[shape_dims - 2];
+    }
+
+    size_t outer   = 0;
+    size_t channel = 0;
+    size_t spatial = 0;
+    GetChannelDims(shape, outer, channel, spatial);
+
+    attr.type  = 1;
+    attr.shape = shape;
+    attr.data.resize(outer * channel * spatial * sizeof(float));
+
+    TransposeLastTwo(static_cast<const char*>(tensor.Data()),
+                     attr.data.data(),
+                     sizeof(float),
+                     outer,
+                     spatial,
+                     channel);
+
+    return Status::kSuccess;
+}
+
 }  // namespace SimpleInfer
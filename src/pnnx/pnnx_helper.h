@@ -1,7 +1,11 @@
 #ifndef SIMPLE_INFER_SRC_PNNX_PNNX_HELPER_H_
 #define SIMPLE_INFER_SRC_PNNX_PNNX_HELPER_H_
 
+#include <vector>
+
 #include "ir.h"
+#include "tensor.h"
+#include "types.h"
 
 namespace SimpleInfer {
 
@@ -21,6 +25,19 @@ bool CheckAttr(const pnnx::Operator* op,
                const std::string& name,
                const int type);
 
+// pnnx shapes are NCHW, tensors are NHWC when rank > 3
+std::vector<int> PnnxToNHWCShape(const std::vector<int>& shape);
+
+// constant data of a pnnx.Attribute operator, its only attr or the one named
+// "data", nullptr if not a constant
+const pnnx::Attribute* GetConstantAttr(const pnnx::Operator* op);
+
+// attribute of any pnnx type to an NHWC tensor owning its memory
+Status AttributeToTensor(const pnnx::Attribute& attr, Tensor& tensor);
+
+// NHWC tensor back to an f32 attribute, same layout as pnnx
+Status TensorToAttribute(const Tensor& tensor, pnnx::Attribute& attr);
+
 }  // namespace SimpleInfer
 
 #endif  // SIMPLE_INFER_SRC_PNNX_PNNX_HELPER_H_
@@ -0,0 +1,273 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace SimpleInfer {
+
+static std::string ShapesToString(const std::vector<std::vector<int>>& shapes) {
+    std::string str;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (i > 0) {
+            str += ",";
+        }
+
+        str += "[";
+        for (size_t j = 0; j < shapes[i].size(); ++j) {
+            if (j > 0) {
+                str += ",";
+            }
+
+            str += std::to_string(shapes[i][j]);
+        }
+        str += "]";
+    }
+
+    return str;
+}
+
+static std::string EscapeJson(const std::string& str) {
+    std::string escaped;
+    for (const char c : str) {
+        if ('"' == c || '\\' == c) {
+            escaped += '\\';
+        }
+
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+static std::vector<std::vector<int>> GetShapes(
+    const std::vector<TensorNode*>& tensor_nodes) {
+    std::vector<std::vector<int>> shapes;
+    for (const TensorNode* tensor_node : tensor_nodes) {
+        shapes.push_back(tensor_node->tensor.Shape());
+    }
+
+    return shapes;
+}
+
+Profiler::Profiler(size_t max_events)
+    : origin_(std::chrono::steady_clock::now()), max_events_(max_events) {}
+
+Profiler::~Profiler() {}
+
+void Profiler::BeginRun() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ++run_;
+}
+
+Status Profiler::Forward(Layer* layer) {
+    const double start = Now();
+
+    Status ret = layer->Forward();
+
+    const double end = Now();
+
+    ProfileEvent event;
+    event.name          = layer->GetOp()->name;
+    event.type          = layer->GetOp()->type;
+    event.start         = start;
+    event.end           = end;
+    event.input_shapes  = GetShapes(layer->GetInputNodes());
+    event.output_shapes = GetShapes(layer->GetOutputNodes());
+    event.flops         = layer->GetFlops();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (events_.size() >= max_events_) {
+            ++dropped_;
+            return ret;
+        }
+
+        event.thread_id = GetThreadId();
+        event.run       = run_;
+
+        events_.push_back(std::move(event));
+    }
+
+    return ret;
+}
+
+void Profiler::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    events_.clear();
+    run_     = 0;
+    dropped_ = 0;
+}
+
+const std::vector<ProfileEvent>& Profiler::GetEvents() const {
+    return events_;
+}
+
+size_t Profiler::GetDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return dropped_;
+}
+
+Status Profiler::SaveChromeTrace(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        LOG(ERROR) << "SaveChromeTrace fail [can not open " << path << "]";
+        return Status::kFail;
+    }
+
+    file << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < events_.size(); ++i) {
+        const ProfileEvent& event = events_[i];
+
+        file << absl::StrFormat(
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,"
+            "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"run\":%d,"
+            "\"inputs\":\"%s\",\"outputs\":\"%s\",\"flops\":%d}}",
+            EscapeJson(event.name),
+            EscapeJson(event.type),
+            event.thread_id,
+            event.start,
+            event.end - event.start,
+            event.run,
+            ShapesToString(event.input_shapes),
+            ShapesToString(event.output_shapes),
+            event.flops);
+
+        file << ((i + 1 < events_.size()) ? ",\n" : "\n");
+    }
+    file << "],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!file.good()) {
+        LOG(ERROR) << "SaveChromeTrace fail [write " << path << "]";
+        return Status::kFail;
+    }
+
+    return Status::kSuccess;
+}
+
+std::string Profiler::Summary() const {
+    struct LayerSummary {
+        std::string name;
+        std::string type;
+        std::string output_shapes;
+        int count     = 0;
+        double total  = 0.0;
+        double min    = 0.0;
+        double max    = 0.0;
+        int64_t flops = 0;
+    };
+
+    std::vector<LayerSummary> summaries;
+    std::map<std::string, size_t> summary_index;
+    double total   = 0.0;
+    int run        = 0;
+    size_t dropped = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        run     = run_;
+        dropped = dropped_;
+
+        for (const ProfileEvent& event : events_) {
+            const double duration = event.end - event.start;
+
+            if (summary_index.count(event.name) <= 0) {
+                summary_index[event.name] = summaries.size();
+
+                LayerSummary summary;
+                summary.name          = event.name;
+                summary.type          = event.type;
+                summary.output_shapes = ShapesToString(event.output_shapes);
+                summary.min           = duration;
+                summary.max           = duration;
+                summary.flops         = event.flops;
+                summaries.push_back(summary);
+            }
+
+            LayerSummary& summary = summaries[summary_index[event.name]];
+            summary.count += 1;
+            summary.total += duration;
+            summary.min = (std::min)(summary.min, duration);
+            summary.max = (std::max)(summary.max, duration);
+
+            total += duration;
+        }
+    }
+
+    std::stable_sort(summaries.begin(),
+                     summaries.end(),
+                     [](const LayerSummary& a, const LayerSummary& b) {
+                         return a.total > b.total;
+                     });
+
+    std::ostringstream ss;
+    ss << absl::StrFormat("%-24s %-20s %6s %10s %10s %10s %6s %8s  %s\n",
+                          "name",
+                          "type",
+                          "count",
+                          "avg(us)",
+                          "min(us)",
+                          "max(us)",
+                          "%",
+                          "GFLOPS",
+                          "output");
+
+    for (const LayerSummary& summary : summaries) {
+        const double avg     = summary.total / summary.count;
+        const double percent = (total > 0.0) ? summary.total / total * 100.0
+                                             : 0.0;
+        const double gflops =
+            (avg > 0.0) ? (double)summary.flops / avg * 1e-3 : 0.0;
+
+        ss << absl::StrFormat(
+            "%-24s %-20s %6d %10.1f %10.1f %10.1f %6.2f %8.2f  %s\n",
+            summary.name,
+            summary.type,
+            summary.count,
+            avg,
+            summary.min,
+            summary.max,
+            percent,
+            gflops,
+            summary.output_shapes);
+    }
+
+    ss << absl::StrFormat("total %.1f us in %d runs\n", total, run);
+
+    if (dropped > 0) {
+        ss << absl::StrFormat("%d events dropped, over %d stored\n",
+                              dropped,
+                              max_events_);
+    }
+
+    return ss.str();
+}
+
+double Profiler::Now() const {
+    const auto now = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(now - origin_).count();
+}
+
+int Profiler::GetThreadId() {
+    const std::thread::id id = std::this_thread::get_id();
+
+    auto iter = thread_ids_.find(id);
+    if (thread_ids_.end() != iter) {
+        return iter->second;
+    }
+
+    const int thread_id = (int)thread_ids_.size();
+    thread_ids_[id]     = thread_id;
+
+    return thread_id;
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,86 @@
+#ifndef SIMPLE_INFER_SRC_PROFILER_H_
+#define SIMPLE_INFER_SRC_PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "layer.h"
+#include "types.h"
+
+namespace SimpleInfer {
+
+struct ProfileEvent {
+    std::string name;
+    std::string type;
+
+    int thread_id = 0;
+    int run       = 0;
+
+    // microseconds since profiler creation
+    double start = 0.0;
+    double end   = 0.0;
+
+    std::vector<std::vector<int>> input_shapes;
+    std::vector<std::vector<int>> output_shapes;
+
+    int64_t flops = 0;
+};
+
+// events kept by default, a few hundred runs of a large model
+static const size_t kProfilerMaxEvents = 1 << 16;
+
+// Records one event per layer Forward, engine only creates it when profiling
+// is enabled, so a disabled profiler costs a null check. Events beyond
+// max_events are counted but not stored, until Clear().
+class Profiler {
+public:
+    explicit Profiler(size_t max_events = kProfilerMaxEvents);
+
+    ~Profiler();
+
+public:
+    // start a new run, called once per engine Forward
+    void BeginRun();
+
+    // forward layer and record its event, safe from any thread
+    Status Forward(Layer* layer);
+
+    void Clear();
+
+    const std::vector<ProfileEvent>& GetEvents() const;
+
+    // events not stored since the last Clear()
+    size_t GetDroppedCount() const;
+
+    // chrome://tracing or perfetto trace_event json
+    Status SaveChromeTrace(const std::string& path) const;
+
+    // per layer statistics over all runs, slowest first
+    std::string Summary() const;
+
+protected:
+    double Now() const;
+
+    int GetThreadId();
+
+protected:
+    std::chrono::steady_clock::time_point origin_;
+
+    int run_ = 0;
+
+    size_t max_events_ = 0;
+    size_t dropped_    = 0;
+
+    mutable std::mutex mutex_;
+    std::vector<ProfileEvent> events_;
+    std::map<std::thread::id, int> thread_ids_;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_PROFILER_H_
@@ -0,0 +1,305 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+
+namespace SimpleInfer {
+
+Scheduler::Scheduler() {}
+
+Scheduler::~Scheduler() {
+    Deinit();
+}
+
+Status Scheduler::Init(const std::vector<Layer*>& layers,
+                       Context* context,
+                       int max_parallel) {
+    Deinit();
+
+    if (nullptr == context || nullptr == context->GetThreadPool()) {
+        LOG(ERROR) << "Scheduler::Init fail [empty context]";
+        return Status::kErrorContext;
+    }
+
+    thread_pool_ = context->GetThreadPool();
+
+    const int num_tasks = (int)layers.size();
+
+    tasks_.resize(num_tasks);
+
+    std::map<const TensorNode*, int> producers;
+    for (int i = 0; i < num_tasks; ++i) {
+        tasks_[i].layer = layers[i];
+        tasks_[i].cost  = EstimateCost(layers[i]);
+
+        for (const TensorNode* output : layers[i]->GetOutputNodes()) {
+            producers[output] = i;
+        }
+    }
+
+    for (int i = 0; i < num_tasks; ++i) {
+        std::vector<int> predecessors;
+        for (const TensorNode* input : tasks_[i].layer->GetInputNodes()) {
+            auto producer_iter = producers.find(input);
+            if (producers.end() == producer_iter) {
+                // graph input
+                continue;
+            }
+
+            if (producer_iter->second >= i) {
+                LOG(ERROR) << "Scheduler::Init fail [layers not in "
+                              "topological order]";
+                return Status::kFail;
+            }
+
+            predecessors.push_back(producer_iter->second);
+        }
+
+        std::sort(predecessors.begin(), predecessors.end());
+        predecessors.erase(
+            std::unique(predecessors.begin(), predecessors.end()),
+            predecessors.end());
+
+        tasks_[i].num_predecessors = (int)predecessors.size();
+        for (const int predecessor : predecessors) {
+            tasks_[predecessor].successors.push_back(i);
+        }
+    }
+
+    // critical path, reverse topological order
+    for (int i = num_tasks - 1; i >= 0; --i) {
+        double successor_priority = 0.0;
+        for (const int successor : tasks_[i].successors) {
+            successor_priority =
+                (std::max)(successor_priority, tasks_[successor].priority);
+        }
+
+        tasks_[i].priority = tasks_[i].cost + successor_priority;
+    }
+
+    const int num_threads = context->GetEigenThreadPoolDevice()->numThreads();
+
+    // width of the graph with enough workers
+    num_parallel_ = Simulate(num_tasks);
+    num_parallel_ = (std::min)(num_parallel_, num_threads);
+    if (max_parallel > 0) {
+        num_parallel_ = (std::min)(num_parallel_, max_parallel);
+    }
+    num_parallel_ = (std::max)(num_parallel_, 1);
+
+    // schedule with the real number of workers
+    Simulate(num_parallel_);
+
+    // workers count against the thread budget too
+    const int num_compute_threads =
+        (std::max)(num_threads - (num_parallel_ - 1), 1);
+
+    // give a layer the share of threads it has on average while it runs
+    for (int i = 0; i < num_tasks; ++i) {
+        Task& task = tasks_[i];
+
+        double concurrency = 1.0;
+        if (task.end > task.start) {
+            double overlap = 0.0;
+            for (const Task& other : tasks_) {
+                const double begin = (std::max)(task.start, other.start);
+                const double end   = (std::min)(task.end, other.end);
+                if (end > begin) {
+                    overlap += end - begin;
+                }
+            }
+
+            concurrency = overlap / (task.end - task.start);
+        }
+
+        task.num_threads = (std::max)(
+            (int)std::lround(num_compute_threads /
+                             (std::max)(concurrency, 1.0)),
+            1);
+
+        task.device.reset(
+            new Eigen::ThreadPoolDevice(thread_pool_, task.num_threads));
+        task.layer->SetEigenThreadPoolDevice(task.device.get());
+    }
+
+    if (num_parallel_ > 1) {
+        const AffinityThreadEnvironment environment(context->GetCpuIds());
+        worker_pool_.reset(
+            new AffinityThreadPool(num_parallel_ - 1, true, environment));
+    }
+
+    LOG(INFO) << "scheduler of [" << num_tasks << "] layers, parallel ["
+              << num_parallel_ << "]";
+
+    return Status::kSuccess;
+}
+
+void Scheduler::Deinit() {
+    worker_pool_.reset();
+
+    for (Task& task : tasks_) {
+        task.layer->SetEigenThreadPoolDevice(nullptr);
+    }
+
+    tasks_.clear();
+
+    thread_pool_  = nullptr;
+    num_parallel_ = 1;
+}
+
+Status Scheduler::Run(Profiler* profiler) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ready_tasks_ = std::priority_queue<std::pair<double, int>>();
+        remaining_.resize(tasks_.size());
+        for (size_t i = 0; i < tasks_.size(); ++i) {
+            remaining_[i] = tasks_[i].num_predecessors;
+            if (0 == remaining_[i]) {
+                ready_tasks_.push(std::make_pair(tasks_[i].priority, (int)i));
+            }
+        }
+
+        num_finished_ = 0;
+        status_       = Status::kSuccess;
+    }
+
+    const int num_workers =
+        (nullptr == worker_pool_) ? 0 : worker_pool_->NumThreads();
+
+    Eigen::Barrier barrier((unsigned int)num_workers);
+    for (int i = 0; i < num_workers; ++i) {
+        worker_pool_->Schedule([this, profiler, &barrier]() {
+            Work(profiler);
+            barrier.Notify();
+        });
+    }
+
+    Work(profiler);
+
+    barrier.Wait();
+
+    return status_;
+}
+
+double Scheduler::EstimateCost(Layer* layer) {
+    // memory traffic counts like compute, keeps cheap layers above zero
+    double bytes = 0.0;
+    for (const auto* tensor_nodes :
+         {&layer->GetInputNodes(), &layer->GetOutputNodes()}) {
+        for (const TensorNode* tensor_node : *tensor_nodes) {
+            double size = ElementSize(tensor_node->tensor.GetDataType());
+            for (const int s : tensor_node->tensor.Shape()) {
+                size *= s;
+            }
+
+            bytes += size;
+        }
+    }
+
+    return (double)layer->GetFlops() + bytes + 1.0;
+}
+
+int Scheduler::Simulate(int num_workers) {
+    const int num_tasks = (int)tasks_.size();
+
+    std::vector<int> remaining(num_tasks);
+    std::priority_queue<std::pair<double, int>> ready;
+    for (int i = 0; i < num_tasks; ++i) {
+        remaining[i] = tasks_[i].num_predecessors;
+        if (0 == remaining[i]) {
+            ready.push(std::make_pair(tasks_[i].priority, i));
+        }
+    }
+
+    // (end time, task), earliest first
+    std::priority_queue<std::pair<double, int>,
+                        std::vector<std::pair<double, int>>,
+                        std::greater<std::pair<double, int>>>
+        running;
+
+    double time      = 0.0;
+    int max_running  = 0;
+    int num_finished = 0;
+    while (num_finished < num_tasks) {
+        while (!ready.empty() && (int)running.size() < num_workers) {
+            const int index = ready.top().second;
+            ready.pop();
+
+            tasks_[index].start = time;
+            tasks_[index].end   = time + tasks_[index].cost;
+            running.push(std::make_pair(tasks_[index].end, index));
+        }
+
+        max_running = (std::max)(max_running, (int)running.size());
+
+        if (running.empty()) {
+            break;
+        }
+
+        time = running.top().first;
+        while (!running.empty() && running.top().first <= time) {
+            const int index = running.top().second;
+            running.pop();
+
+            ++num_finished;
+            for (const int successor : tasks_[index].successors) {
+                if (0 == --remaining[successor]) {
+                    ready.push(std::make_pair(tasks_[successor].priority,
+                                              successor));
+                }
+            }
+        }
+    }
+
+    return max_running;
+}
+
+void Scheduler::Work(Profiler* profiler) {
+    const int num_tasks = (int)tasks_.size();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        condition_.wait(lock, [this, num_tasks]() {
+            return !ready_tasks_.empty() || num_finished_ >= num_tasks ||
+                   Status::kSuccess != status_;
+        });
+
+        if (num_finished_ >= num_tasks || Status::kSuccess != status_) {
+            return;
+        }
+
+        const int index = ready_tasks_.top().second;
+        ready_tasks_.pop();
+
+        lock.unlock();
+
+        Layer* layer = tasks_[index].layer;
+        Status ret   = (nullptr == profiler) ? layer->Forward()
+                                             : profiler->Forward(layer);
+
+        lock.lock();
+
+        if (Status::kSuccess != ret) {
+            LOG(ERROR) << "layer [" << layer->GetOp()->name
+                       << "] forward fail";
+            status_ = ret;
+            condition_.notify_all();
+            return;
+        }
+
+        ++num_finished_;
+        for (const int successor : tasks_[index].successors) {
+            if (0 == --remaining_[successor]) {
+                ready_tasks_.push(
+                    std::make_pair(tasks_[successor].priority, successor));
+            }
+        }
+
+        condition_.notify_all();
+    }
+}
+
+}  // namespace SimpleInfer
@@ -0,0 +1,90 @@
+#ifndef SIMPLE_INFER_SRC_SCHEDULER_H_
+#define SIMPLE_INFER_SRC_SCHEDULER_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "context.h"
+#include "layer.h"
+#include "profiler.h"
+#include "types.h"
+
+namespace SimpleInfer {
+
+// Runs independent layers concurrently from a cost model. Layer cost comes
+// from FLOPs and tensor sizes, ready layers on the critical path go first,
+// and the core budget is split between concurrent branches and the threads
+// inside each layer.
+class Scheduler {
+public:
+    Scheduler();
+
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+
+    Scheduler& operator=(const Scheduler&) = delete;
+
+public:
+    // layers in topological order, max_parallel <= 0 for no limit
+    Status Init(const std::vector<Layer*>& layers,
+                Context* context,
+                int max_parallel);
+
+    void Deinit();
+
+    // profiler can be nullptr
+    Status Run(Profiler* profiler);
+
+protected:
+    struct Task {
+        Layer* layer = nullptr;
+
+        std::vector<int> successors;
+        int num_predecessors = 0;
+
+        double cost     = 0.0;
+        double priority = 0.0;  // cost of the longest path to a graph output
+
+        // simulated schedule
+        double start = 0.0;
+        double end   = 0.0;
+
+        int num_threads = 1;
+        std::unique_ptr<Eigen::ThreadPoolDevice> device;
+    };
+
+    static double EstimateCost(Layer* layer);
+
+    // list scheduling on num_workers, returns max number of running tasks
+    int Simulate(int num_workers);
+
+    void Work(Profiler* profiler);
+
+protected:
+    std::vector<Task> tasks_;
+
+    Eigen::ThreadPoolInterface* thread_pool_ = nullptr;
+
+    int num_parallel_ = 1;
+
+    // extra workers own their threads, a layer waiting in Parallel() never
+    // holds a thread of the pool its blocks run on, pinned like that pool
+    std::unique_ptr<AffinityThreadPool> worker_pool_;
+
+    // state of a run
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::priority_queue<std::pair<double, int>> ready_tasks_;
+    std::vector<int> remaining_;
+    int num_finished_ = 0;
+    Status status_    = Status::kSuccess;
+};
+
+}  // namespace SimpleInfer
+
+#endif  // SIMPLE_INFER_SRC_SCHEDULER_H_
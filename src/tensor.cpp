@@ -1,8 +1,10 @@
 #include "tensor.h"
 
-#include <cstdlib>
+#include <cstring>
+#include <utility>
 
 #include "logger.h"
+#include "memory_arena.h"
 
 namespace SimpleInfer {
 
@@ -28,18 +30,64 @@ Tensor::~Tensor() {
 Tensor::Tensor(const Tensor& tensor)
     : data_type_(tensor.data_type_),
       shape_(tensor.shape_),
-      use_internal_data_(false),
+      row_stride_(tensor.row_stride_),
+      layout_(tensor.layout_),
+      storage_(tensor.storage_),
       data_(tensor.data_) {}
 
 Tensor& Tensor::operator=(const Tensor& tensor) {
-    Deallocate();
+    if (this == &tensor) {
+        return *this;
+    }
+
+    data_type_ = tensor.data_type_;
+
+    // reuse capacity, no allocation on the hot path
+    shape_.assign(tensor.shape_.begin(), tensor.shape_.end());
+
+    row_stride_ = tensor.row_stride_;
+
+    layout_ = tensor.layout_;
+
+    storage_ = tensor.storage_;
+    data_    = tensor.data_;
+
+    return *this;
+}
+
+Tensor::Tensor(Tensor&& tensor) noexcept
+    : data_type_(tensor.data_type_),
+      shape_(std::move(tensor.shape_)),
+      row_stride_(tensor.row_stride_),
+      layout_(tensor.layout_),
+      storage_(std::move(tensor.storage_)),
+      data_(tensor.data_) {
+    tensor.data_type_  = DataType::kNone;
+    tensor.row_stride_ = 0;
+    tensor.layout_     = Layout::kNHWC;
+    tensor.data_       = nullptr;
+}
+
+Tensor& Tensor::operator=(Tensor&& tensor) noexcept {
+    if (this == &tensor) {
+        return *this;
+    }
 
     data_type_ = tensor.data_type_;
 
-    shape_ = tensor.shape_;
+    shape_ = std::move(tensor.shape_);
+
+    row_stride_ = tensor.row_stride_;
+
+    layout_ = tensor.layout_;
 
-    use_internal_data_ = false;
-    data_              = tensor.data_;
+    storage_ = std::move(tensor.storage_);
+    data_    = tensor.data_;
+
+    tensor.data_type_  = DataType::kNone;
+    tensor.row_stride_ = 0;
+    tensor.layout_     = Layout::kNHWC;
+    tensor.data_       = nullptr;
 
     return *this;
 }
@@ -51,10 +99,11 @@ Status Tensor::Allocate() {
     }
 
     if (total_size > 0) {
-        // TODO: use memory pool
-        data_ = malloc(total_size);
-        if (nullptr != data_) {
-            use_internal_data_ = true;
+        void* data = AlignedMalloc(total_size);
+        if (nullptr != data) {
+            storage_.reset(data, AlignedFree);
+            data_       = data;
+            row_stride_ = 0;
 
             return Status::kSuccess;
         }
@@ -68,7 +117,7 @@ Status Tensor::Allocate() {
 Status Tensor::Allocate(const DataType data_type,
                         const std::vector<int>& shape) {
     if ((data_type_ == data_type) && IsSameShape(shape_, shape) &&
-        use_internal_data_ && (nullptr != data_)) {
+        (nullptr != storage_) && IsContiguous()) {
         return Status::kSuccess;
     }
 
@@ -82,13 +131,10 @@ Status Tensor::Allocate(const DataType data_type,
 }
 
 Status Tensor::Deallocate() {
-    if (use_internal_data_) {
-        if (nullptr != data_) {
-            free(data_);
-            data_ = nullptr;
-        }
-
-        use_internal_data_ = false;
+    if (nullptr != storage_) {
+        // freed with the last tensor sharing it
+        storage_.reset();
+        data_ = nullptr;
 
         return Status::kSuccess;
     }
@@ -96,6 +142,94 @@ Status Tensor::Deallocate() {
     return Status::kFail;
 }
 
+Status Tensor::SetData(void* data) {
+    storage_.reset();
+
+    data_ = data;
+
+    return Status::kSuccess;
+}
+
+Status Tensor::SetData(const std::shared_ptr<void>& storage, size_t offset) {
+    if (nullptr == storage) {
+        return Status::kEmpty;
+    }
+
+    storage_ = storage;
+    data_    = static_cast<char*>(storage.get()) + offset;
+
+    return Status::kSuccess;
+}
+
+Status Tensor::Reshape(const std::vector<int>& shape) {
+    int total_size = 1;
+    for (const auto s : shape_) {
+        total_size *= s;
+    }
+
+    int new_total_size = 1;
+    for (const auto s : shape) {
+        new_total_size *= s;
+    }
+
+    if (!IsContiguous() || total_size != new_total_size) {
+        LOG(ERROR) << "Tensor Reshape Fail, size " << total_size << " -> "
+                   << new_total_size;
+        return Status::kErrorShape;
+    }
+
+    shape_ = shape;
+
+    return Status::kSuccess;
+}
+
+long Tensor::UseCount() const {
+    return storage_.use_count();
+}
+
+void* Tensor::Data() const {
+    return data_;
+}
+
+Status Tensor::CopyTo(Tensor& dst) const {
+    if (this == &dst || nullptr == data_) {
+        return Status::kFail;
+    }
+
+    // views of dst would see the copy
+    if (dst.UseCount() > 1) {
+        dst = Tensor();
+    }
+
+    CHECK_STATUS(dst.Allocate(data_type_, shape_));
+
+    dst.SetLayout(layout_);
+
+    const size_t element_size = ElementSize(data_type_);
+    const size_t row_size     = shape_.empty() ? 1 : shape_.back();
+
+    size_t rows = 1;
+    for (size_t i = 0; i + 1 < shape_.size(); ++i) {
+        rows *= shape_[i];
+    }
+
+    if (IsContiguous()) {
+        memcpy(dst.data_, data_, rows * row_size * element_size);
+        return Status::kSuccess;
+    }
+
+    const char* src_row = static_cast<const char*>(data_);
+    char* dst_row       = static_cast<char*>(dst.data_);
+    for (size_t i = 0; i < rows; ++i) {
+        memcpy(dst_row, src_row, row_size * element_size);
+
+        src_row += RowStride() * element_size;
+        dst_row += row_size * element_size;
+    }
+
+    return Status::kSuccess;
+}
+
 const DataType Tensor::GetDataType() const {
     return data_type_;
 }
@@ -104,4 +238,34 @@ const std::vector<int>& Tensor::Shape() const {
     return shape_;
 }
 
+int Tensor::RowStride() const {
+    if (row_stride_ > 0 || shape_.empty()) {
+        return row_stride_;
+    }
+
+    return shape_.back();
+}
+
+Status Tensor::SetRowStride(const int row_stride) {
+    if (nullptr != storage_ || shape_.empty() || row_stride < shape_.back()) {
+        return Status::kFail;
+    }
+
+    row_stride_ = (row_stride == shape_.back()) ? 0 : row_stride;
+
+    return Status::kSuccess;
+}
+
+bool Tensor::IsContiguous() const {
+    return (0 == row_stride_);
+}
+
+Layout Tensor::GetLayout() const {
+    return layout_;
+}
+
+void Tensor::SetLayout(const Layout layout) {
+    layout_ = layout;
+}
+
 }  // namespace SimpleInfer
@@ -1,6 +1,7 @@
 #ifndef SIMPLE_INFER_SRC_TENSOR_NODE_H_
 #define SIMPLE_INFER_SRC_TENSOR_NODE_H_
 
+#include "memory_arena.h"
 #include "pnnx/ir.h"
 #include "tensor.h"
 
@@ -9,6 +10,16 @@ namespace SimpleInfer {
 struct TensorNode {
     pnnx::Operand* operand = nullptr;
     Tensor tensor;
+
+    // share memory of another tensor node at byte offset
+    TensorNode* alias   = nullptr;
+    size_t alias_offset = 0;
+
+    // byte offset in the engine tensor arena, see MemoryPlanner
+    size_t memory_offset = 0;
+
+    // block of a graph output the offset is in instead, nullptr for the arena
+    MemoryArena* block = nullptr;
 };
 
 }  // namespace SimpleInfer
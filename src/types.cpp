@@ -119,4 +119,29 @@ bool IsSameShape(const std::vector<int>& shape0,
     return true;
 }
 
+int LayoutBlock(const Layout layout) {
+    switch (layout) {
+        case Layout::kNC4HW4:
+            return 4;
+        case Layout::kNC8HW8:
+            return 8;
+        default:
+            return 0;
+    }
+
+    return 0;
+}
+
+std::vector<int> LayoutShape(const std::vector<int>& shape,
+                             const Layout layout) {
+    const int block = LayoutBlock(layout);
+    if (block <= 0 || 4 != shape.size()) {
+        return shape;
+    }
+
+    const int channel_blocks = (shape[3] + block - 1) / block;
+
+    return {shape[0] * channel_blocks, shape[1], shape[2], block};
+}
+
 }  // namespace SimpleInfer
@@ -0,0 +1,78 @@
+#ifndef SIMPLE_INFER_TEST_GRAPH_BUILDER_H_
+#define SIMPLE_INFER_TEST_GRAPH_BUILDER_H_
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "pnnx/ir.h"
+
+// build small pnnx graphs in memory for graph level tests
+
+inline pnnx::Operand* AddOperand(pnnx::Graph& graph,
+                                 const std::string& name,
+                                 const std::vector<int>& shape) {
+    pnnx::Operand* operand = graph.new_operand(name);
+    operand->type          = 1;  // f32
+    operand->shape         = shape;
+
+    return operand;
+}
+
+inline pnnx::Operator* AddOperator(pnnx::Graph& graph,
+                                   const std::string& type,
+                                   const std::string& name,
+                                   const std::vector<pnnx::Operand*>& inputs,
+                                   const std::vector<pnnx::Operand*>& outputs) {
+    pnnx::Operator* op = graph.new_operator(type, name);
+
+    for (auto input : inputs) {
+        input->consumers.push_back(op);
+        op->inputs.push_back(input);
+    }
+
+    for (auto output : outputs) {
+        output->producer = op;
+        op->outputs.push_back(output);
+    }
+
+    return op;
+}
+
+// graph saved to the temp directory so an engine can load it, the files are
+// removed again when it goes out of scope
+class TempModel {
+public:
+    TempModel(pnnx::Graph& graph, const std::string& name) {
+        const std::filesystem::path dir =
+            std::filesystem::temp_directory_path();
+
+        param_path_ = (dir / (name + ".pnnx.param")).string();
+        bin_path_   = (dir / (name + ".pnnx.bin")).string();
+
+        graph.save(param_path_, bin_path_);
+    }
+
+    // the files belong to one instance
+    TempModel(const TempModel&) = delete;
+
+    ~TempModel() {
+        std::remove(param_path_.c_str());
+        std::remove(bin_path_.c_str());
+    }
+
+    const std::string& ParamPath() const {
+        return param_path_;
+    }
+
+    const std::string& BinPath() const {
+        return bin_path_;
+    }
+
+private:
+    std::string param_path_;
+    std::string bin_path_;
+};
+
+#endif  // SIMPLE_INFER_TEST_GRAPH_BUILDER_H_
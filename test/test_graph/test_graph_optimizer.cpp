@@ -0,0 +1,298 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "graph_optimizer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace SimpleInfer;
+
+static const float* GetFloatAttr(const pnnx::Operator* op,
+                                 const std::string& name) {
+    return reinterpret_cast<const float*>(op->attrs.at(name).data.data());
+}
+
+// in -> conv 1x1 (2 -> 2) -> bn -> out
+static void CreateConvBatchNormGraph(pnnx::Graph& graph, bool use_bias) {
+    pnnx::Operand* in  = AddOperand(graph, "in", {1, 2, 4, 4});
+    pnnx::Operand* t0  = AddOperand(graph, "t0", {1, 2, 4, 4});
+    pnnx::Operand* out = AddOperand(graph, "out", {1, 2, 4, 4});
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+
+    pnnx::Operator* conv = AddOperator(graph, "nn.Conv2d", "conv", {in}, {t0});
+    conv->params["out_channels"] = 2;
+    conv->params["bias"]         = use_bias;
+    conv->attrs["weight"] =
+        pnnx::Attribute({2, 2, 1, 1}, {1.0f, 2.0f, 3.0f, 4.0f});
+    if (use_bias) {
+        conv->attrs["bias"] = pnnx::Attribute({2}, {0.5f, -0.5f});
+    }
+
+    pnnx::Operator* bn =
+        AddOperator(graph, "nn.BatchNorm2d", "bn", {t0}, {out});
+    bn->params["num_features"] = 2;
+    bn->params["eps"]          = 0.0f;
+    bn->params["affine"]       = true;
+    bn->attrs["running_mean"]  = pnnx::Attribute({2}, {1.0f, 2.0f});
+    bn->attrs["running_var"]   = pnnx::Attribute({2}, {4.0f, 16.0f});
+    bn->attrs["weight"]        = pnnx::Attribute({2}, {2.0f, 8.0f});
+    bn->attrs["bias"]          = pnnx::Attribute({2}, {1.0f, 3.0f});
+
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+}
+
+TEST_CASE("Test FuseConv2dBatchNorm2d", "[GraphOptimizer]") {
+    for (const bool use_bias : {true, false}) {
+        pnnx::Graph graph;
+        CreateConvBatchNormGraph(graph, use_bias);
+
+        CHECK_EQ(Status::kSuccess, FuseConv2dBatchNorm2d(&graph));
+
+        REQUIRE(3 == graph.ops.size());
+        CHECK(nullptr == graph.get_operand("t0"));
+
+        const pnnx::Operator* conv = graph.ops[1];
+        CHECK_EQ(conv->type, "nn.Conv2d");
+        CHECK_EQ(conv->outputs[0]->name, "out");
+        CHECK(conv == graph.get_operand("out")->producer);
+        CHECK(conv->params.at("bias").b);
+
+        // scale = gamma / sqrt(var) = {1, 2}
+        const float* weight = GetFloatAttr(conv, "weight");
+        CHECK_FLOAT_EQ(weight[0], 1.0f);
+        CHECK_FLOAT_EQ(weight[1], 2.0f);
+        CHECK_FLOAT_EQ(weight[2], 6.0f);
+        CHECK_FLOAT_EQ(weight[3], 8.0f);
+
+        // bias = (bias - mean) * scale + beta
+        const float* bias = GetFloatAttr(conv, "bias");
+        if (use_bias) {
+            CHECK_FLOAT_EQ(bias[0], 0.5f);
+            CHECK_FLOAT_EQ(bias[1], -2.0f);
+        } else {
+            CHECK_FLOAT_EQ(bias[0], 0.0f);
+            CHECK_FLOAT_EQ(bias[1], -1.0f);
+        }
+    }
+}
+
+TEST_CASE("Test FuseConv2dBatchNorm2d shared output", "[GraphOptimizer]") {
+    pnnx::Graph graph;
+    CreateConvBatchNormGraph(graph, true);
+
+    // conv output read by another layer, can not fold
+    pnnx::Operand* t0  = graph.get_operand("t0");
+    pnnx::Operand* out = AddOperand(graph, "out1", {1, 2, 4, 4});
+    AddOperator(graph, "nn.ReLU", "relu", {t0}, {out});
+
+    CHECK_EQ(Status::kSuccess, FuseConv2dBatchNorm2d(&graph));
+
+    CHECK_EQ(graph.ops.size(), 5);
+    CHECK(nullptr != graph.get_operand("t0"));
+}
+
+TEST_CASE("Test FuseConv2dActivation", "[GraphOptimizer]") {
+    // in -> conv -> bn -> silu -> relu -> out
+    pnnx::Graph graph;
+    CreateConvBatchNormGraph(graph, true);
+
+    pnnx::Operand* out = graph.get_operand("out");
+    pnnx::Operand* t1  = AddOperand(graph, "t1", {1, 2, 4, 4});
+    pnnx::Operand* t2  = AddOperand(graph, "t2", {1, 2, 4, 4});
+
+    pnnx::Operator* output = out->consumers[0];
+    out->consumers.clear();
+    output->inputs.clear();
+
+    AddOperator(graph, "nn.SiLU", "silu", {out}, {t1});
+    AddOperator(graph, "nn.ReLU", "relu", {t1}, {t2});
+
+    t2->consumers.push_back(output);
+    output->inputs.push_back(t2);
+
+    CHECK_EQ(Status::kSuccess, OptimizeGraph(&graph));
+
+    // only the first activation is fused
+    REQUIRE(4 == graph.ops.size());
+    CHECK(nullptr == graph.get_operand("out"));
+
+    const pnnx::Operator* conv = graph.get_operand("t1")->producer;
+    CHECK_EQ(conv->type, "nn.Conv2d");
+    CHECK_EQ(conv->params.at("activation").s, "nn.SiLU");
+    CHECK_EQ(graph.get_operand("t1")->consumers[0]->type, "nn.ReLU");
+}
+
+TEST_CASE("Test FuseConv2dResidual", "[GraphOptimizer]") {
+    // in -> conv0 -> t0 -> conv1 -> t1 -> add(t1, t0) -> t2 -> relu -> out
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 2, 4, 4};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0  = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1  = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2  = AddOperand(graph, "t2", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.Conv2d", "conv0", {in}, {t0});
+    AddOperator(graph, "nn.Conv2d", "conv1", {t0}, {t1});
+    pnnx::Operator* add = AddOperator(graph, "BinaryOp", "add", {t1, t0}, {t2});
+    add->params["0"]    = 0;
+    AddOperator(graph, "nn.ReLU", "relu", {t2}, {out});
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    CHECK_EQ(Status::kSuccess, OptimizeGraph(&graph));
+
+    REQUIRE(4 == graph.ops.size());
+    CHECK(nullptr == graph.get_operand("t1"));
+    CHECK(nullptr == graph.get_operand("t2"));
+
+    // conv0 output is read twice, only conv1 takes the add
+    const pnnx::Operator* conv = graph.get_operand("out")->producer;
+    CHECK_EQ(conv->name, "conv1");
+    REQUIRE(2 == conv->inputs.size());
+    CHECK(t0 == conv->inputs[1]);
+    CHECK_EQ(conv->params.count("activation"), 0);
+    CHECK_EQ(conv->params.at("residual_activation").s, "nn.ReLU");
+
+    for (const pnnx::Operator* consumer : t0->consumers) {
+        CHECK_EQ(consumer->name, "conv1");
+    }
+}
+
+TEST_CASE("Test EliminateDeadOperators", "[GraphOptimizer]") {
+    // in -> relu -> out, in -> sigmoid -> t1 -> silu -> t2 unused
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 2, 4, 4};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+    pnnx::Operand* t1  = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2  = AddOperand(graph, "t2", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "relu", {in}, {out});
+    AddOperator(graph, "nn.Sigmoid", "sigmoid", {in}, {t1});
+    AddOperator(graph, "nn.SiLU", "silu", {t1}, {t2});
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    CHECK_EQ(Status::kSuccess, EliminateDeadOperators(&graph));
+
+    REQUIRE(3 == graph.ops.size());
+    CHECK(nullptr == graph.get_operand("t1"));
+    CHECK(nullptr == graph.get_operand("t2"));
+
+    REQUIRE(1 == in->consumers.size());
+    CHECK_EQ(in->consumers[0]->name, "relu");
+}
+
+TEST_CASE("Test FoldConstants", "[GraphOptimizer]") {
+    // relu(a + b) is constant, in + relu(a + b) -> out
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 2, 1, 3};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* a   = AddOperand(graph, "a", shape);
+    pnnx::Operand* b   = AddOperand(graph, "b", shape);
+    pnnx::Operand* t0  = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1  = AddOperand(graph, "t1", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+
+    // relu before its producer, graph order is not topological
+    AddOperator(graph, "nn.ReLU", "relu", {t0}, {t1});
+
+    pnnx::Operator* const_a =
+        AddOperator(graph, "pnnx.Attribute", "const_a", {}, {a});
+    const_a->attrs["data"] =
+        pnnx::Attribute({1, 2, 1, 3}, {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f});
+
+    pnnx::Operator* const_b =
+        AddOperator(graph, "pnnx.Attribute", "const_b", {}, {b});
+    const_b->attrs["data"] =
+        pnnx::Attribute({1, 2, 1, 3}, {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f});
+
+    pnnx::Operator* add0 = AddOperator(graph, "BinaryOp", "add0", {a, b}, {t0});
+    add0->params["0"]    = 0;
+
+    pnnx::Operator* add1 =
+        AddOperator(graph, "BinaryOp", "add1", {in, t1}, {out});
+    add1->params["0"] = 0;
+
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    CHECK_EQ(Status::kSuccess, FoldConstants(&graph));
+    CHECK_EQ(Status::kSuccess, EliminateDeadOperators(&graph));
+
+    // input, relu, add1, output
+    REQUIRE(4 == graph.ops.size());
+    CHECK(nullptr == graph.get_operand("a"));
+    CHECK(nullptr == graph.get_operand("b"));
+    CHECK(nullptr == graph.get_operand("t0"));
+
+    const pnnx::Operator* relu = t1->producer;
+    CHECK_EQ(relu->type, "pnnx.Attribute");
+    CHECK(relu->inputs.empty());
+    CHECK(add1 == t1->consumers[0]);
+
+    // same NCHW layout as the inputs
+    const pnnx::Attribute& data = relu->attrs.at("data");
+    REQUIRE(data.shape == shape);
+    REQUIRE(6 * sizeof(float) == data.data.size());
+
+    const float* value = reinterpret_cast<const float*>(data.data.data());
+    const float expected[6] = {1.5f, 0.0f, 3.5f, 0.0f, 5.5f, 0.0f};
+    for (int i = 0; i < 6; ++i) {
+        CHECK_FLOAT_EQ(value[i], expected[i]);
+    }
+}
+
+TEST_CASE("Test FoldConstants int constant", "[GraphOptimizer]") {
+    // relu of an i32 constant is left as it is
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 2, 1, 3};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* a   = AddOperand(graph, "a", shape);
+    pnnx::Operand* t0  = AddOperand(graph, "t0", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+    a->type            = 4;  // i32
+    t0->type           = 4;
+
+    const std::vector<int32_t> value{1, -2, 3, -4, 5, -6};
+
+    pnnx::Attribute attr;
+    attr.type  = 4;
+    attr.shape = shape;
+    attr.data.resize(value.size() * sizeof(int32_t));
+    std::memcpy(attr.data.data(), value.data(), attr.data.size());
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+
+    pnnx::Operator* const_a =
+        AddOperator(graph, "pnnx.Attribute", "const_a", {}, {a});
+    const_a->attrs["data"] = attr;
+
+    AddOperator(graph, "nn.ReLU", "relu", {a}, {t0});
+
+    pnnx::Operator* add =
+        AddOperator(graph, "BinaryOp", "add", {in, t0}, {out});
+    add->params["0"] = 0;
+
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    CHECK_EQ(Status::kSuccess, FoldConstants(&graph));
+
+    REQUIRE(5 == graph.ops.size());
+    CHECK_EQ(t0->producer->type, "nn.ReLU");
+    CHECK(const_a->attrs.at("data") == attr);
+}
@@ -0,0 +1,114 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "layout_planner.h"
+
+#include <string>
+#include <vector>
+
+using namespace SimpleInfer;
+
+static void AddTensors(const pnnx::Graph& graph, LayoutPlanner& planner) {
+    for (const auto operand : graph.operands) {
+        planner.AddTensor(operand->name);
+    }
+}
+
+TEST_CASE("Test LayoutPlanner chain", "[LayoutPlanner]") {
+    // in -> conv0 -> relu -> conv1 -> out, relu follows the convs
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 8, 8};
+
+    pnnx::Operand* in = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0 = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1 = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2 = AddOperand(graph, "t2", shape);
+
+    pnnx::Operator* input =
+        AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    pnnx::Operator* conv0 =
+        AddOperator(graph, "nn.Conv2d", "conv0", {in}, {t0});
+    pnnx::Operator* relu = AddOperator(graph, "nn.ReLU", "relu", {t0}, {t1});
+    pnnx::Operator* conv1 =
+        AddOperator(graph, "nn.Conv2d", "conv1", {t1}, {t2});
+    pnnx::Operator* output =
+        AddOperator(graph, "pnnx.Output", "output", {t2}, {});
+
+    LayoutPlanner planner;
+    AddTensors(graph, planner);
+    planner.SetChoice(conv0, LayoutPlanner::Choice::kBlocked);
+    planner.SetChoice(conv1, LayoutPlanner::Choice::kBlocked);
+
+    CHECK_EQ(Status::kSuccess, planner.Plan(&graph));
+
+    CHECK(!planner.IsBlocked(input));
+    CHECK(planner.IsBlocked(conv0));
+    CHECK(planner.IsBlocked(relu));
+    CHECK(planner.IsBlocked(conv1));
+    CHECK(!planner.IsBlocked(output));
+
+    // graph input and output
+    CHECK_EQ(planner.GetReorderCount(), 2);
+}
+
+TEST_CASE("Test LayoutPlanner pinned", "[LayoutPlanner]") {
+    // in -> conv0 -> t0 -> add -> t2 -> cat1 -> out
+    // in -> cat0  -> t1 ->
+    //
+    // a blocked add would reorder t1 and t2 instead of t0
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 8, 8};
+
+    pnnx::Operand* in = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0 = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1 = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2 = AddOperand(graph, "t2", shape);
+    pnnx::Operand* t3 = AddOperand(graph, "t3", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    pnnx::Operator* conv0 =
+        AddOperator(graph, "nn.Conv2d", "conv0", {in}, {t0});
+    pnnx::Operator* cat0 = AddOperator(graph, "torch.cat", "cat0", {in}, {t1});
+    pnnx::Operator* add =
+        AddOperator(graph, "pnnx.Expression", "add", {t0, t1}, {t2});
+    pnnx::Operator* cat1 = AddOperator(graph, "torch.cat", "cat1", {t2}, {t3});
+    AddOperator(graph, "pnnx.Output", "output", {t3}, {});
+
+    LayoutPlanner planner;
+    AddTensors(graph, planner);
+    planner.SetChoice(conv0, LayoutPlanner::Choice::kBlocked);
+    planner.SetChoice(cat0, LayoutPlanner::Choice::kNHWC);
+    planner.SetChoice(cat1, LayoutPlanner::Choice::kNHWC);
+
+    CHECK_EQ(Status::kSuccess, planner.Plan(&graph));
+
+    CHECK(planner.IsBlocked(conv0));
+    CHECK(!planner.IsBlocked(cat0));
+    CHECK(!planner.IsBlocked(add));
+
+    // in and t0
+    CHECK_EQ(planner.GetReorderCount(), 2);
+}
+
+TEST_CASE("Test LayoutPlanner nothing blocked", "[LayoutPlanner]") {
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 8, 8};
+
+    pnnx::Operand* in = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0 = AddOperand(graph, "t0", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    pnnx::Operator* relu = AddOperator(graph, "nn.ReLU", "relu", {in}, {t0});
+    AddOperator(graph, "pnnx.Output", "output", {t0}, {});
+
+    LayoutPlanner planner;
+    AddTensors(graph, planner);
+
+    CHECK_EQ(Status::kSuccess, planner.Plan(&graph));
+
+    CHECK(!planner.IsBlocked(relu));
+    CHECK_EQ(planner.GetReorderCount(), 0);
+}
@@ -1,6 +1,8 @@
 #include "common.h"
+#include "graph_builder.h"
 
 #include "layer/cat.h"
+#include "layer/relu.h"
 
 #include <algorithm>
 
@@ -63,3 +65,94 @@ TEST_CASE("Test Cat layer [add]") {
         }
     }
 }
+
+// relu writes into channel views of the output, then cat runs on the views
+static void CheckCatOfViews(SimpleInfer::Cat& cat_layer) {
+    using namespace SimpleInfer;
+
+    // set tensor
+    std::vector<int> in_shape0{1, 8, 8, 3};
+    std::vector<int> in_shape1{1, 8, 8, 2};
+    std::vector<int> out_shape{1, 8, 8, 5};
+
+    Tensor input0_tensor(DataType::kFloat32, in_shape0, true);
+    Tensor input1_tensor(DataType::kFloat32, in_shape1, true);
+    Tensor output_tensor(DataType::kFloat32, out_shape, true);
+
+    EigenTensorMap<float, 4> input0_eigen_tensor =
+        input0_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> input1_eigen_tensor =
+        input1_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 4>();
+
+    input0_eigen_tensor.setRandom();
+    input1_eigen_tensor.setRandom();
+    output_eigen_tensor.setZero();
+
+    // relu writes into channel views of output
+    Tensor view0_tensor(DataType::kFloat32, in_shape0, false);
+    Tensor view1_tensor(DataType::kFloat32, in_shape1, false);
+
+    CHECK_EQ(Status::kSuccess,
+             view0_tensor.SetData(output_eigen_tensor.data()));
+    CHECK_EQ(Status::kSuccess, view0_tensor.SetRowStride(out_shape[3]));
+    CHECK_EQ(Status::kSuccess,
+             view1_tensor.SetData(output_eigen_tensor.data() + in_shape0[3]));
+    CHECK_EQ(Status::kSuccess, view1_tensor.SetRowStride(out_shape[3]));
+
+    ReLU relu_layer;
+    CHECK_EQ(Status::kSuccess, relu_layer.Forward(input0_tensor, view0_tensor));
+    CHECK_EQ(Status::kSuccess, relu_layer.Forward(input1_tensor, view1_tensor));
+
+    // cat of views copies nothing
+    CHECK_EQ(Status::kSuccess,
+             cat_layer.Forward({view0_tensor, view1_tensor}, output_tensor));
+
+    // check
+    for (int i = 0; i < out_shape[0]; ++i) {
+        for (int j = 0; j < out_shape[1]; ++j) {
+            for (int k = 0; k < out_shape[2]; ++k) {
+                for (int l = 0; l < out_shape[3]; ++l) {
+                    float value;
+                    if (l < in_shape0[3]) {
+                        value = input0_eigen_tensor(i, j, k, l);
+                    } else {
+                        value = input1_eigen_tensor(i, j, k, l - in_shape0[3]);
+                    }
+
+                    CHECK_EQ(output_eigen_tensor(i, j, k, l),
+                             (std::max)(value, 0.0f));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Test Cat layer [view]") {
+    SimpleInfer::Cat cat_layer;
+    cat_layer.dim_ = 1;  // channel
+
+    CheckCatOfViews(cat_layer);
+}
+
+TEST_CASE("Test Cat layer [view] negative dim") {
+    using namespace SimpleInfer;
+
+    pnnx::Graph graph;
+
+    pnnx::Operand* in0 = AddOperand(graph, "in0", {1, 3, 8, 8});
+    pnnx::Operand* in1 = AddOperand(graph, "in1", {1, 2, 8, 8});
+    pnnx::Operand* out = AddOperand(graph, "out", {1, 5, 8, 8});
+
+    pnnx::Operator* op =
+        AddOperator(graph, "torch.cat", "cat", {in0, in1}, {out});
+    op->params["dim"] = pnnx::Parameter(-3);
+
+    // -3 of NCHW is channel
+    Cat cat_layer;
+    REQUIRE(Status::kSuccess == cat_layer.Init(op));
+    CHECK_EQ(cat_layer.dim_, 1);
+
+    CheckCatOfViews(cat_layer);
+}
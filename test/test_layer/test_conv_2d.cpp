@@ -556,3 +556,444 @@ TEST_CASE("Test Conv2d layer 3", "[Conv]") {
         }
     }
 }
+
+static float ReferenceActivation(const float x,
+                                 const SimpleInfer::ActivationType activation) {
+    using SimpleInfer::ActivationType;
+
+    switch (activation) {
+        case ActivationType::kReLU:
+            return (std::max)(x, 0.0f);
+        case ActivationType::kSiLU:
+            return x / (1.0f + std::exp(-x));
+        case ActivationType::kSigmoid:
+            return 1.0f / (1.0f + std::exp(-x));
+        case ActivationType::kHardSwish:
+            return x * (std::min)((std::max)(x / 6.0f + 0.5f, 0.0f), 1.0f);
+        case ActivationType::kHardSigmoid:
+            return (std::min)((std::max)(x / 6.0f + 0.5f, 0.0f), 1.0f);
+        default:
+            return x;
+    }
+}
+
+static void TestConv2dEpilogue(
+    const int groups,
+    const bool use_winograd,
+    const SimpleInfer::ActivationType activation,
+    const bool use_residual,
+    const SimpleInfer::ActivationType residual_activation) {
+    using namespace SimpleInfer;
+
+    const int in_image_height = 9;
+    const int in_image_width  = 9;
+    const int in_channel      = 8;
+    const int out_channel     = 14;
+    const int kernel_h        = 3;
+    const int kernel_w        = 3;
+    const int padding         = 1;
+
+    const int in_channel_group  = in_channel / groups;
+    const int out_channel_group = out_channel / groups;
+
+    std::vector<int> in_shape{1, in_image_height, in_image_width, in_channel};
+    std::vector<int> out_shape{1, in_image_height, in_image_width, out_channel};
+
+    Tensor input_tensor(DataType::kFloat32, in_shape, true);
+    Tensor output_tensor(DataType::kFloat32, out_shape, true);
+
+    EigenTensorMap<float, 4> input_eigen_tensor =
+        input_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 4>();
+
+    input_eigen_tensor.setRandom();
+    input_eigen_tensor = input_eigen_tensor * 4.0f - 2.0f;
+
+    Tensor residual_tensor(DataType::kFloat32, out_shape, true);
+
+    EigenTensorMap<float, 4> residual_eigen_tensor =
+        residual_tensor.GetEigenTensor<float, 4>();
+
+    residual_eigen_tensor.setRandom();
+    residual_eigen_tensor = residual_eigen_tensor * 4.0f - 2.0f;
+
+    // set layer
+    Conv2d conv_2d_layer;
+    conv_2d_layer.use_bias_     = true;
+    conv_2d_layer.in_channels_  = in_channel;
+    conv_2d_layer.out_channels_ = out_channel;
+    conv_2d_layer.groups_       = groups;
+    conv_2d_layer.kernel_h_     = kernel_h;
+    conv_2d_layer.kernel_w_     = kernel_w;
+    conv_2d_layer.stride_h_     = 1;
+    conv_2d_layer.stride_w_     = 1;
+    conv_2d_layer.dilation_h_   = 1;
+    conv_2d_layer.dilation_w_   = 1;
+    conv_2d_layer.padding_mode_ = Conv2d::PaddingMode::kZeros;
+    conv_2d_layer.padding_t_    = padding;
+    conv_2d_layer.padding_b_    = padding;
+    conv_2d_layer.padding_l_    = padding;
+    conv_2d_layer.padding_r_    = padding;
+    conv_2d_layer.activation_   = activation;
+
+    conv_2d_layer.use_residual_        = use_residual;
+    conv_2d_layer.residual_activation_ = residual_activation;
+
+    EigenDSize<4> origin_shape(out_channel,
+                               in_channel_group,
+                               kernel_h,
+                               kernel_w);
+    EigenDSize<4> shuffle_shape(kernel_h,
+                                kernel_w,
+                                in_channel_group,
+                                out_channel);
+
+    EigenTensor<float, 4> origin_kernel(origin_shape);
+    origin_kernel.setRandom();
+
+    conv_2d_layer.weight_shape_ = shuffle_shape;
+    conv_2d_layer.weight_.resize(shuffle_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 4> shuffle_kernel(
+        reinterpret_cast<float*>(conv_2d_layer.weight_.data()),
+        shuffle_shape);
+
+    EigenDSize<4> shuffle(2, 3, 1, 0);
+    shuffle_kernel = origin_kernel.shuffle(shuffle);
+
+    EigenDSize<1> bias_shape(out_channel);
+    conv_2d_layer.bias_shape_ = bias_shape;
+    conv_2d_layer.bias_.resize(bias_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 1> bias_tensor(
+        reinterpret_cast<float*>(conv_2d_layer.bias_.data()),
+        bias_shape);
+    bias_tensor.setRandom();
+
+    if (use_winograd) {
+        CHECK_EQ(Status::kSuccess, conv_2d_layer.InitWinograd());
+        CHECK(conv_2d_layer.use_winograd_);
+    }
+
+    if (use_residual) {
+        std::vector<Tensor> inputs{input_tensor, residual_tensor};
+
+        CHECK_EQ(Status::kSuccess,
+                 conv_2d_layer.Forward(inputs, output_tensor));
+    } else {
+        CHECK_EQ(Status::kSuccess,
+                 conv_2d_layer.Forward(input_tensor, output_tensor));
+    }
+
+    // check
+    for (int j = 0; j < out_shape[1]; ++j) {
+        for (int k = 0; k < out_shape[2]; ++k) {
+            for (int oc = 0; oc < out_channel; ++oc) {
+                const int g = oc / out_channel_group;
+
+                float sum = 0.0f;
+                for (int c = 0; c < in_channel_group; ++c) {
+                    const int ic = g * in_channel_group + c;
+                    for (int h = 0; h < kernel_h; ++h) {
+                        for (int w = 0; w < kernel_w; ++w) {
+                            int input_h = j - padding + h;
+                            int input_w = k - padding + w;
+                            if (input_h < 0 || input_h >= in_shape[1] ||
+                                input_w < 0 || input_w >= in_shape[2]) {
+                                continue;
+                            }
+
+                            sum += input_eigen_tensor(0, input_h, input_w, ic) *
+                                   origin_kernel(oc, c, h, w);
+                        }
+                    }
+                }
+
+                sum = ReferenceActivation(sum + bias_tensor(oc), activation);
+
+                if (use_residual) {
+                    sum = ReferenceActivation(
+                        sum + residual_eigen_tensor(0, j, k, oc),
+                        residual_activation);
+                }
+
+                const float out = output_eigen_tensor(0, j, k, oc);
+                CHECK_FLOAT_EPS_EQ(out, sum, 2e-3);
+            }
+        }
+    }
+}
+
+TEST_CASE("Test Conv2d fused activation", "[Conv]") {
+    using SimpleInfer::ActivationType;
+
+    const ActivationType activations[] = {ActivationType::kNone,
+                                          ActivationType::kReLU,
+                                          ActivationType::kSiLU,
+                                          ActivationType::kSigmoid,
+                                          ActivationType::kHardSwish,
+                                          ActivationType::kHardSigmoid};
+
+    for (const ActivationType activation : activations) {
+        // im2col
+        TestConv2dEpilogue(1, false, activation, false, ActivationType::kNone);
+
+        // im2col with group
+        TestConv2dEpilogue(2, false, activation, false, ActivationType::kNone);
+
+        // winograd
+        TestConv2dEpilogue(1, true, activation, false, ActivationType::kNone);
+    }
+}
+
+TEST_CASE("Test Conv2d fused residual", "[Conv]") {
+    using SimpleInfer::ActivationType;
+
+    // yolo bottleneck adds after the activation, resnet block activates
+    // after the add
+    const ActivationType activations[][2] = {
+        {ActivationType::kSiLU, ActivationType::kNone},
+        {ActivationType::kNone, ActivationType::kReLU}};
+
+    for (const auto& activation : activations) {
+        TestConv2dEpilogue(1, false, activation[0], true, activation[1]);
+        TestConv2dEpilogue(2, false, activation[0], true, activation[1]);
+        TestConv2dEpilogue(1, true, activation[0], true, activation[1]);
+    }
+}
+
+TEST_CASE("Test Conv2d pointwise", "[Conv]") {
+    using namespace SimpleInfer;
+
+    // odd channels leave a tail in both the gemm and the epilogue
+    const int batch           = 2;
+    const int in_image_height = 7;
+    const int in_image_width  = 5;
+    const int in_channel      = 13;
+    const int out_channel     = 22;
+
+    std::vector<int> in_shape{batch,
+                              in_image_height,
+                              in_image_width,
+                              in_channel};
+    std::vector<int> out_shape{batch,
+                               in_image_height,
+                               in_image_width,
+                               out_channel};
+
+    Tensor input_tensor(DataType::kFloat32, in_shape, true);
+    Tensor output_tensor(DataType::kFloat32, out_shape, true);
+    Tensor residual_tensor(DataType::kFloat32, out_shape, true);
+
+    EigenTensorMap<float, 4> input_eigen_tensor =
+        input_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> residual_eigen_tensor =
+        residual_tensor.GetEigenTensor<float, 4>();
+
+    input_eigen_tensor.setRandom();
+    input_eigen_tensor = input_eigen_tensor * 4.0f - 2.0f;
+    residual_eigen_tensor.setRandom();
+
+    // set layer
+    Conv2d conv_2d_layer;
+    conv_2d_layer.use_bias_     = true;
+    conv_2d_layer.in_channels_  = in_channel;
+    conv_2d_layer.out_channels_ = out_channel;
+    conv_2d_layer.groups_       = 1;
+    conv_2d_layer.kernel_h_     = 1;
+    conv_2d_layer.kernel_w_     = 1;
+    conv_2d_layer.stride_h_     = 1;
+    conv_2d_layer.stride_w_     = 1;
+    conv_2d_layer.dilation_h_   = 1;
+    conv_2d_layer.dilation_w_   = 1;
+    conv_2d_layer.padding_mode_ = Conv2d::PaddingMode::kZeros;
+    conv_2d_layer.activation_   = ActivationType::kSiLU;
+    conv_2d_layer.use_residual_ = true;
+
+    EigenDSize<2> weight_shape(in_channel, out_channel);
+    EigenTensor<float, 2> kernel(weight_shape);
+    kernel.setRandom();
+
+    conv_2d_layer.weight_shape_ = EigenDSize<4>(1, 1, in_channel, out_channel);
+    conv_2d_layer.weight_.resize(weight_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 2>(
+        reinterpret_cast<float*>(conv_2d_layer.weight_.data()),
+        weight_shape) = kernel;
+
+    EigenDSize<1> bias_shape(out_channel);
+    conv_2d_layer.bias_shape_ = bias_shape;
+    conv_2d_layer.bias_.resize(bias_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 1> bias_tensor(
+        reinterpret_cast<float*>(conv_2d_layer.bias_.data()),
+        bias_shape);
+    bias_tensor.setRandom();
+
+    CHECK_EQ(Status::kSuccess, conv_2d_layer.InitPointwise());
+    CHECK(conv_2d_layer.use_pointwise_);
+
+    std::vector<Tensor> inputs{input_tensor, residual_tensor};
+    CHECK_EQ(Status::kSuccess, conv_2d_layer.Forward(inputs, output_tensor));
+
+    // check
+    for (int i = 0; i < batch; ++i) {
+        for (int j = 0; j < in_image_height; ++j) {
+            for (int k = 0; k < in_image_width; ++k) {
+                for (int oc = 0; oc < out_channel; ++oc) {
+                    float sum = 0.0f;
+                    for (int ic = 0; ic < in_channel; ++ic) {
+                        sum += input_eigen_tensor(i, j, k, ic) * kernel(ic, oc);
+                    }
+
+                    sum = ReferenceActivation(sum + bias_tensor(oc),
+                                              ActivationType::kSiLU) +
+                          residual_eigen_tensor(i, j, k, oc);
+
+                    const float out = output_eigen_tensor(i, j, k, oc);
+                    CHECK_FLOAT_EPS_EQ(out, sum, 2e-3);
+                }
+            }
+        }
+    }
+}
+
+static void TestDepthwise(const int kernel,
+                          const int stride,
+                          const int padding,
+                          const int channel,
+                          const bool use_residual) {
+    using namespace SimpleInfer;
+
+    const int batch           = 2;
+    const int in_image_height = 11;
+    const int in_image_width  = 10;
+
+    const int out_image_height =
+        (in_image_height + 2 * padding - kernel) / stride + 1;
+    const int out_image_width =
+        (in_image_width + 2 * padding - kernel) / stride + 1;
+
+    std::vector<int> in_shape{batch, in_image_height, in_image_width, channel};
+    std::vector<int> out_shape{batch,
+                               out_image_height,
+                               out_image_width,
+                               channel};
+
+    Tensor input_tensor(DataType::kFloat32, in_shape, true);
+    Tensor output_tensor(DataType::kFloat32, out_shape, true);
+    Tensor residual_tensor(DataType::kFloat32, out_shape, true);
+
+    EigenTensorMap<float, 4> input_eigen_tensor =
+        input_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> residual_eigen_tensor =
+        residual_tensor.GetEigenTensor<float, 4>();
+
+    input_eigen_tensor.setRandom();
+    input_eigen_tensor = input_eigen_tensor * 4.0f - 2.0f;
+    residual_eigen_tensor.setRandom();
+
+    // set layer
+    Conv2d conv_2d_layer;
+    conv_2d_layer.use_bias_     = true;
+    conv_2d_layer.in_channels_  = channel;
+    conv_2d_layer.out_channels_ = channel;
+    conv_2d_layer.groups_       = channel;
+    conv_2d_layer.kernel_h_     = kernel;
+    conv_2d_layer.kernel_w_     = kernel;
+    conv_2d_layer.stride_h_     = stride;
+    conv_2d_layer.stride_w_     = stride;
+    conv_2d_layer.dilation_h_   = 1;
+    conv_2d_layer.dilation_w_   = 1;
+    conv_2d_layer.padding_mode_ = Conv2d::PaddingMode::kZeros;
+    conv_2d_layer.padding_t_    = padding;
+    conv_2d_layer.padding_b_    = padding;
+    conv_2d_layer.padding_l_    = padding;
+    conv_2d_layer.padding_r_    = padding;
+    conv_2d_layer.activation_   = ActivationType::kHardSwish;
+    conv_2d_layer.use_residual_ = use_residual;
+
+    // HWIO with one input channel per group
+    EigenDSize<4> weight_shape(kernel, kernel, 1, channel);
+    EigenTensor<float, 4> kernel_tensor(weight_shape);
+    kernel_tensor.setRandom();
+
+    conv_2d_layer.weight_shape_ = weight_shape;
+    conv_2d_layer.weight_.resize(weight_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 4>(
+        reinterpret_cast<float*>(conv_2d_layer.weight_.data()),
+        weight_shape) = kernel_tensor;
+
+    EigenDSize<1> bias_shape(channel);
+    conv_2d_layer.bias_shape_ = bias_shape;
+    conv_2d_layer.bias_.resize(bias_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 1> bias_tensor(
+        reinterpret_cast<float*>(conv_2d_layer.bias_.data()),
+        bias_shape);
+    bias_tensor.setRandom();
+
+    CHECK_EQ(Status::kSuccess, conv_2d_layer.InitDepthwise());
+    CHECK(conv_2d_layer.use_depthwise_);
+
+    if (use_residual) {
+        std::vector<Tensor> inputs{input_tensor, residual_tensor};
+
+        CHECK_EQ(Status::kSuccess,
+                 conv_2d_layer.Forward(inputs, output_tensor));
+    } else {
+        CHECK_EQ(Status::kSuccess,
+                 conv_2d_layer.Forward(input_tensor, output_tensor));
+    }
+
+    // check
+    for (int i = 0; i < batch; ++i) {
+        for (int j = 0; j < out_image_height; ++j) {
+            for (int k = 0; k < out_image_width; ++k) {
+                for (int c = 0; c < channel; ++c) {
+                    float sum = 0.0f;
+                    for (int h = 0; h < kernel; ++h) {
+                        for (int w = 0; w < kernel; ++w) {
+                            int input_h = j * stride - padding + h;
+                            int input_w = k * stride - padding + w;
+                            if (input_h < 0 || input_h >= in_image_height ||
+                                input_w < 0 || input_w >= in_image_width) {
+                                continue;
+                            }
+
+                            sum += input_eigen_tensor(i, input_h, input_w, c) *
+                                   kernel_tensor(h, w, 0, c);
+                        }
+                    }
+
+                    sum = ReferenceActivation(sum + bias_tensor(c),
+                                              ActivationType::kHardSwish);
+
+                    if (use_residual) {
+                        sum += residual_eigen_tensor(i, j, k, c);
+                    }
+
+                    const float out = output_eigen_tensor(i, j, k, c);
+                    CHECK_FLOAT_EPS_EQ(out, sum, 2e-3);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Test Conv2d depthwise", "[Conv]") {
+    // channels: vector tail overlap, scalar only, whole vectors
+    const int channels[] = {6, 3, 16};
+
+    for (const int kernel : {3, 5}) {
+        for (const int stride : {1, 2}) {
+            for (const int channel : channels) {
+                TestDepthwise(kernel, stride, kernel / 2, channel, false);
+            }
+
+            // no padding, and padding wider than the kernel half
+            TestDepthwise(kernel, stride, 0, 8, true);
+            TestDepthwise(kernel, stride, kernel / 2 + 1, 5, true);
+        }
+    }
+}
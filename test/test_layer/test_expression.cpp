@@ -0,0 +1,126 @@
+#include "common.h"
+
+#include "layer/expression.h"
+
+#include <algorithm>
+#include <cmath>
+
+TEST_CASE("Test Expression parse") {
+    using namespace SimpleInfer;
+
+    std::vector<ExpressionStep> steps;
+    CHECK_EQ(Status::kSuccess,
+             Expression::Parse("add(mul(@0,@1),sqrt(2.5))", steps));
+
+    // operands come before their operation, result is the last step
+    REQUIRE(6 == steps.size());
+    CHECK(ExpressionOpType::kAdd == steps.back().type);
+    CHECK(ExpressionOpType::kSqrt == steps[steps.back().b].type);
+    CHECK(ExpressionOpType::kMul == steps[steps.back().a].type);
+    for (int i = 0; i < (int)steps.size(); ++i) {
+        CHECK(steps[i].a < i);
+        CHECK(steps[i].b < i);
+    }
+
+    CHECK(Status::kSuccess != Expression::Parse("size(@0,1)", steps));
+    CHECK(Status::kSuccess != Expression::Parse("add(@0,[1,2])", steps));
+    CHECK(Status::kSuccess != Expression::Parse("add(@0)", steps));
+    CHECK(Status::kSuccess != Expression::Parse("@0", steps));
+}
+
+TEST_CASE("Test Expression layer [broadcast]") {
+    using namespace SimpleInfer;
+
+    // (@0 - @1) * rsqrt(@2 + 0.001), @1 and @2 per channel
+    std::vector<int> shape{2, 7, 9, 67};
+    std::vector<int> channel_shape{1, 1, 1, 67};
+    std::vector<int> row_shape{2, 7, 9, 1};
+
+    Tensor input0_tensor(DataType::kFloat32, shape, true);
+    Tensor input1_tensor(DataType::kFloat32, channel_shape, true);
+    Tensor input2_tensor(DataType::kFloat32, row_shape, true);
+    Tensor output_tensor(DataType::kFloat32, shape, true);
+
+    EigenTensorMap<float, 4> input0_eigen_tensor =
+        input0_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> input1_eigen_tensor =
+        input1_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> input2_eigen_tensor =
+        input2_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 4>();
+
+    input0_eigen_tensor.setRandom();
+    input1_eigen_tensor.setRandom();
+    input2_eigen_tensor.setRandom();
+
+    // set layer
+    Expression expression_layer;
+    CHECK_EQ(Status::kSuccess,
+             Expression::Parse("mul(sub(@0,@1),rsqrt(add(@2,0.001)))",
+                               expression_layer.steps_));
+    CHECK_EQ(Status::kSuccess,
+             expression_layer.Forward(
+                 {input0_tensor, input1_tensor, input2_tensor},
+                 output_tensor));
+
+    // check
+    for (int i = 0; i < shape[0]; ++i) {
+        for (int j = 0; j < shape[1]; ++j) {
+            for (int k = 0; k < shape[2]; ++k) {
+                for (int l = 0; l < shape[3]; ++l) {
+                    const float expected =
+                        (input0_eigen_tensor(i, j, k, l) -
+                         input1_eigen_tensor(0, 0, 0, l)) /
+                        std::sqrt(input2_eigen_tensor(i, j, k, 0) + 0.001f);
+                    CHECK_FLOAT_EPS_EQ(output_eigen_tensor(i, j, k, l),
+                                       expected,
+                                       1e-5f);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Test Expression layer [flat]") {
+    using namespace SimpleInfer;
+
+    std::vector<int> shape{1, 33, 31, 5};
+
+    Tensor input0_tensor(DataType::kFloat32, shape, true);
+    Tensor input1_tensor(DataType::kFloat32, shape, true);
+    Tensor output_tensor(DataType::kFloat32, shape, true);
+
+    EigenTensorMap<float, 4> input0_eigen_tensor =
+        input0_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> input1_eigen_tensor =
+        input1_tensor.GetEigenTensor<float, 4>();
+    EigenTensorMap<float, 4> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 4>();
+
+    input0_eigen_tensor.setRandom();
+    input1_eigen_tensor.setRandom();
+
+    // set layer
+    Expression expression_layer;
+    CHECK_EQ(Status::kSuccess,
+             Expression::Parse("maximum(div(neg(@0),add(@1,1)),square(@1))",
+                               expression_layer.steps_));
+    CHECK_EQ(Status::kSuccess,
+             expression_layer.Forward({input0_tensor, input1_tensor},
+                                      output_tensor));
+
+    // check
+    for (int i = 0; i < shape[0]; ++i) {
+        for (int j = 0; j < shape[1]; ++j) {
+            for (int k = 0; k < shape[2]; ++k) {
+                for (int l = 0; l < shape[3]; ++l) {
+                    const float x = input0_eigen_tensor(i, j, k, l);
+                    const float y = input1_eigen_tensor(i, j, k, l);
+                    CHECK_FLOAT_EQ(output_eigen_tensor(i, j, k, l),
+                                   (std::max)(-x / (y + 1.0f), y * y));
+                }
+            }
+        }
+    }
+}
@@ -43,3 +43,42 @@ TEST_CASE("Test Faltten layer") {
         }
     }
 }
+
+TEST_CASE("Test Faltten layer [view]") {
+    using namespace SimpleInfer;
+
+    // set tensor, NHWC -> NCHW keeps memory order
+    std::vector<int> in_shape{2, 1, 1, 128};
+    std::vector<int> out_shape{2, 128};
+
+    Tensor input_tensor(DataType::kFloat32, in_shape, true);
+    Tensor output_tensor(DataType::kFloat32, out_shape, false);
+
+    EigenTensorMap<float, 4> input_eigen_tensor =
+        input_tensor.GetEigenTensor<float, 4>();
+
+    input_eigen_tensor.setRandom();
+
+    EigenTensor<float, 4> input_copy = input_eigen_tensor;
+
+    CHECK_EQ(Status::kSuccess,
+             output_tensor.SetData(input_eigen_tensor.data()));
+
+    // set layer
+    Flatten flatten_layer;
+    flatten_layer.start_dim_ = 1;
+    flatten_layer.end_dim_   = -1;
+
+    CHECK_EQ(Status::kSuccess,
+             flatten_layer.Forward(input_tensor, output_tensor));
+
+    EigenTensorMap<float, 2> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 2>();
+
+    // check
+    for (int i = 0; i < in_shape[0]; ++i) {
+        for (int l = 0; l < in_shape[3]; ++l) {
+            CHECK_EQ(output_eigen_tensor(i, l), input_copy(i, 0, 0, l));
+        }
+    }
+}
@@ -19,7 +19,9 @@ void TestWinograd(const int in_image_height,
                   const int padding_t,
                   const int padding_b,
                   const int padding_l,
-                  const int padding_r) {
+                  const int padding_r,
+                  const int winograd_tile,
+                  const int batch) {
     using namespace SimpleInfer;
 
     const int k_h_size         = (kernel_h - 1) * dilation_h + 1;
@@ -34,8 +36,11 @@ void TestWinograd(const int in_image_height,
     const int start_w = -padding_l;
 
     // set tensor
-    std::vector<int> in_shape{1, in_image_height, in_image_width, in_channel};
-    std::vector<int> out_shape{1,
+    std::vector<int> in_shape{batch,
+                              in_image_height,
+                              in_image_width,
+                              in_channel};
+    std::vector<int> out_shape{batch,
                                out_image_height,
                                out_image_width,
                                out_channel};
@@ -69,8 +74,17 @@ void TestWinograd(const int in_image_height,
     conv_2d_layer.padding_l_    = padding_l;
     conv_2d_layer.padding_r_    = padding_r;
 
-    EigenDSize<4> origin_shape(out_channel, in_channel, kernel_h, kernel_w);
-    EigenDSize<4> shuffle_shape(kernel_h, kernel_w, in_channel, out_channel);
+    const int in_channel_group  = in_channel / groups;
+    const int out_channel_group = out_channel / groups;
+
+    EigenDSize<4> origin_shape(out_channel,
+                               in_channel_group,
+                               kernel_h,
+                               kernel_w);
+    EigenDSize<4> shuffle_shape(kernel_h,
+                                kernel_w,
+                                in_channel_group,
+                                out_channel);
 
     EigenTensor<float, 4> origin_kernel(origin_shape);
     origin_kernel.setRandom();
@@ -94,7 +108,14 @@ void TestWinograd(const int in_image_height,
     bias_tensor.setRandom();
     // bias_tensor.setConstant(1.0f);
 
-    CHECK_EQ(Status::kSuccess, conv_2d_layer.InitWinograd());
+    // 0 picks the tile per layer
+    if (0 == winograd_tile) {
+        CHECK_EQ(Status::kSuccess, conv_2d_layer.InitWinograd());
+        CHECK(conv_2d_layer.use_winograd_);
+    } else {
+        CHECK_EQ(Status::kSuccess, conv_2d_layer.InitWinograd(winograd_tile));
+        CHECK_EQ(conv_2d_layer.winograd_tile_, winograd_tile);
+    }
 
     CHECK_EQ(Status::kSuccess,
              conv_2d_layer.Forward(input_tensor, output_tensor));
@@ -104,8 +125,10 @@ void TestWinograd(const int in_image_height,
         for (int j = 0; j < out_shape[1]; ++j) {
             for (int k = 0; k < out_shape[2]; ++k) {
                 for (int l = 0; l < out_shape[3]; ++l) {
+                    const int g = l / out_channel_group;
+
                     float sum = 0.0f;
-                    for (int c = 0; c < in_channel; ++c) {
+                    for (int c = 0; c < in_channel_group; ++c) {
                         for (int h = 0; h < kernel_h; ++h) {
                             for (int w = 0; w < kernel_w; ++w) {
                                 int input_h =
@@ -117,9 +140,12 @@ void TestWinograd(const int in_image_height,
                                     continue;
                                 }
 
-                                sum +=
-                                    input_eigen_tensor(i, input_h, input_w, c) *
-                                    origin_kernel(l, c, h, w);
+                                sum += input_eigen_tensor(
+                                           i,
+                                           input_h,
+                                           input_w,
+                                           g * in_channel_group + c) *
+                                       origin_kernel(l, c, h, w);
                             }
                         }
                     }
@@ -146,7 +172,9 @@ void TestWinograd(const int in_image_height,
                   const int in_image_width,
                   const int in_channel,
                   const int out_channel,
-                  bool pad) {
+                  bool pad,
+                  const int winograd_tile = 0,
+                  const int batch         = 1) {
     int padding = (pad ? 1 : 0);
 
     TestWinograd(in_image_height,
@@ -163,7 +191,9 @@ void TestWinograd(const int in_image_height,
                  padding,
                  padding,
                  padding,
-                 padding);
+                 padding,
+                 winograd_tile,
+                 batch);
 }
 
 TEST_CASE("Test Winograd", "[Winograd]") {
@@ -197,3 +227,181 @@ TEST_CASE("Test Winograd", "[Winograd]") {
     TestWinograd(4, 4, 256, 32, false);
     TestWinograd(4, 4, 32, 3, false);
 }
+
+TEST_CASE("Test Winograd F(4x4,3x3)", "[Winograd]") {
+    // whole and ragged 4x4 tiles
+    TestWinograd(6, 6, 4, 4, false, 4);
+    TestWinograd(6, 6, 4, 4, true, 4);
+    TestWinograd(7, 9, 4, 4, false, 4);
+    TestWinograd(7, 9, 4, 4, true, 4);
+    TestWinograd(10, 10, 8, 8, true, 4);
+    TestWinograd(3, 3, 4, 4, false, 4);
+
+    // channel tails
+    TestWinograd(8, 8, 5, 4, true, 4);
+    TestWinograd(8, 8, 7, 13, true, 4);
+    TestWinograd(9, 6, 13, 5, false, 4);
+
+    TestWinograd(12, 12, 64, 32, true, 4);
+    TestWinograd(5, 11, 128, 64, true, 4);
+
+    // per layer choice with enough channels
+    TestWinograd(16, 16, 32, 32, true);
+}
+
+TEST_CASE("Test Winograd batch", "[Winograd]") {
+    // images stacked into one pass, tile ranges of threads cross images
+    TestWinograd(6, 10, 8, 8, false, 2, 3);
+    TestWinograd(6, 10, 8, 8, false, 4, 3);
+    TestWinograd(9, 5, 7, 13, true, 2, 4);
+    TestWinograd(9, 5, 7, 13, true, 4, 4);
+
+    // more tiles than one pass holds
+    TestWinograd(70, 70, 4, 4, true, 2, 2);
+    TestWinograd(134, 134, 4, 4, true, 4, 2);
+}
+
+TEST_CASE("Test Winograd padding and groups", "[Winograd]") {
+    // h, w, ic, oc, groups, kernel, stride, dilation, padding t b l r,
+    // tile, batch
+    for (int tile : {0, 2, 4}) {
+        TestWinograd(7, 9, 8, 8, 1, 3, 3, 1, 1, 1, 1, 2, 2, 2, 2, tile, 1);
+        TestWinograd(7, 9, 8, 8, 1, 3, 3, 1, 1, 1, 1, 0, 1, 1, 0, tile, 1);
+        TestWinograd(7, 9, 8, 8, 1, 3, 3, 1, 1, 1, 1, 1, 0, 0, 2, tile, 2);
+        TestWinograd(6, 6, 5, 7, 1, 3, 3, 1, 1, 1, 1, 3, 0, 0, 3, tile, 1);
+        TestWinograd(5, 5, 8, 8, 1, 3, 3, 1, 1, 1, 1, 4, 4, 4, 4, tile, 1);
+
+        TestWinograd(8, 8, 16, 16, 2, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, tile, 1);
+        TestWinograd(9, 7, 32, 48, 4, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, tile, 2);
+        TestWinograd(9, 7, 24, 40, 2, 3, 3, 1, 1, 1, 1, 0, 2, 1, 0, tile, 1);
+    }
+}
+
+void TestWinogradLayout(const int batch,
+                        const int in_image_height,
+                        const int in_image_width,
+                        const int in_channel,
+                        const int out_channel,
+                        bool pad,
+                        const SimpleInfer::Layout layout) {
+    using namespace SimpleInfer;
+
+    const int padding          = (pad ? 1 : 0);
+    const int out_image_height = in_image_height + 2 * padding - 2;
+    const int out_image_width  = in_image_width + 2 * padding - 2;
+
+    std::vector<int> in_shape{batch,
+                              in_image_height,
+                              in_image_width,
+                              in_channel};
+    std::vector<int> out_shape{batch,
+                               out_image_height,
+                               out_image_width,
+                               out_channel};
+
+    Tensor input_tensor(DataType::kFloat32, in_shape, true);
+    Tensor output_tensor(DataType::kFloat32, out_shape, true);
+    Tensor residual_tensor(DataType::kFloat32, out_shape, true);
+
+    input_tensor.GetEigenTensor<float, 4>().setRandom();
+    residual_tensor.GetEigenTensor<float, 4>().setRandom();
+
+    // set layer
+    Conv2d conv_2d_layer;
+    conv_2d_layer.use_bias_     = true;
+    conv_2d_layer.in_channels_  = in_channel;
+    conv_2d_layer.out_channels_ = out_channel;
+    conv_2d_layer.groups_       = 1;
+    conv_2d_layer.kernel_h_     = 3;
+    conv_2d_layer.kernel_w_     = 3;
+    conv_2d_layer.stride_h_     = 1;
+    conv_2d_layer.stride_w_     = 1;
+    conv_2d_layer.dilation_h_   = 1;
+    conv_2d_layer.dilation_w_   = 1;
+    conv_2d_layer.padding_mode_ = Conv2d::PaddingMode::kZeros;
+    conv_2d_layer.padding_t_    = padding;
+    conv_2d_layer.padding_b_    = padding;
+    conv_2d_layer.padding_l_    = padding;
+    conv_2d_layer.padding_r_    = padding;
+    conv_2d_layer.activation_   = ActivationType::kSiLU;
+
+    EigenDSize<4> weight_shape(3, 3, in_channel, out_channel);
+    conv_2d_layer.weight_shape_ = weight_shape;
+    conv_2d_layer.weight_.resize(weight_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 4>(
+        reinterpret_cast<float*>(conv_2d_layer.weight_.data()),
+        weight_shape)
+        .setRandom();
+
+    EigenDSize<1> bias_shape(out_channel);
+    conv_2d_layer.bias_shape_ = bias_shape;
+    conv_2d_layer.bias_.resize(bias_shape.TotalSize() * sizeof(float));
+    EigenTensorMap<float, 1>(
+        reinterpret_cast<float*>(conv_2d_layer.bias_.data()),
+        bias_shape)
+        .setRandom();
+
+    CHECK_EQ(Status::kSuccess, conv_2d_layer.InitWinograd());
+    CHECK(conv_2d_layer.SupportLayout(layout));
+
+    // reference in NHWC
+    CHECK_EQ(
+        Status::kSuccess,
+        conv_2d_layer.Forward(input_tensor,
+                              conv_2d_layer.CreateEpilogue(&residual_tensor),
+                              output_tensor));
+
+    // same layer in blocked layout
+    Tensor blocked_input(DataType::kFloat32,
+                         LayoutShape(in_shape, layout),
+                         true);
+    Tensor blocked_output(DataType::kFloat32,
+                          LayoutShape(out_shape, layout),
+                          true);
+    Tensor blocked_residual(DataType::kFloat32,
+                            LayoutShape(out_shape, layout),
+                            true);
+    blocked_input.SetLayout(layout);
+    blocked_output.SetLayout(layout);
+    blocked_residual.SetLayout(layout);
+
+    CHECK_EQ(Status::kSuccess,
+             ReorderLayout(nullptr, input_tensor, blocked_input, in_channel));
+    CHECK_EQ(Status::kSuccess,
+             ReorderLayout(nullptr,
+                           residual_tensor,
+                           blocked_residual,
+                           out_channel));
+
+    CHECK_EQ(Status::kSuccess,
+             conv_2d_layer.Forward(
+                 blocked_input,
+                 conv_2d_layer.CreateEpilogue(&blocked_residual),
+                 blocked_output));
+
+    Tensor result_tensor(DataType::kFloat32, out_shape, true);
+    CHECK_EQ(
+        Status::kSuccess,
+        ReorderLayout(nullptr, blocked_output, result_tensor, out_channel));
+
+    const EigenTensorMap<float, 1> output_eigen_tensor =
+        output_tensor.GetEigenTensor<float, 1>();
+    const EigenTensorMap<float, 1> result_eigen_tensor =
+        result_tensor.GetEigenTensor<float, 1>();
+
+    for (int i = 0; i < output_eigen_tensor.size(); ++i) {
+        CHECK_FLOAT_EPS_EQ(result_eigen_tensor(i),
+                           output_eigen_tensor(i),
+                           1e-4);
+    }
+}
+
+TEST_CASE("Test Winograd blocked layout", "[Winograd]") {
+    using SimpleInfer::Layout;
+
+    TestWinogradLayout(1, 4, 4, 4, 4, false, Layout::kNC4HW4);
+    TestWinogradLayout(1, 5, 7, 8, 4, true, Layout::kNC4HW4);
+    TestWinogradLayout(2, 6, 6, 8, 16, true, Layout::kNC4HW4);
+    TestWinogradLayout(2, 6, 6, 8, 16, true, Layout::kNC8HW8);
+    TestWinogradLayout(2, 9, 8, 32, 24, false, Layout::kNC8HW8);
+}
@@ -0,0 +1,154 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "engine_impl.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace SimpleInfer;
+
+// in -> relu -> sigmoid -> out
+static TempModel SaveActivationModel() {
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 4, 4};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0  = AddOperand(graph, "t0", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "relu", {in}, {t0});
+    AddOperator(graph, "nn.Sigmoid", "sigmoid", {t0}, {out});
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    return TempModel(graph, "test_engine_memory");
+}
+
+static Tensor CreateInput(const float value) {
+    Tensor input(DataType::kFloat32, {1, 4, 4, 8}, true);
+    input.GetEigenTensor<float, 4>().setConstant(value);
+
+    return input;
+}
+
+TEST_CASE("Test Engine Extract then Forward", "[Engine]") {
+    const TempModel model = SaveActivationModel();
+
+    EngineOptions options;
+    options.num_threads   = 2;
+    options.pipeline_type = PipelineType::kSequential;
+
+    EngineImpl engine;
+    CHECK_EQ(Status::kSuccess,
+             engine.LoadModel(model.ParamPath(), model.BinPath(), options));
+
+    const void* arena_data = engine.GetTensorArena().Data();
+
+    const TensorNode* out_node = engine.GetTensorNode("out");
+    REQUIRE(nullptr != out_node);
+
+    CHECK_EQ(Status::kSuccess, engine.Input("in", CreateInput(-1.0f)));
+    CHECK_EQ(Status::kSuccess, engine.Forward());
+
+    // zero copy, a reference to the output block
+    Tensor first;
+    CHECK_EQ(Status::kSuccess, engine.Extract("out", first));
+    CHECK(nullptr != first.Data());
+    CHECK(first.Data() == out_node->tensor.Data());
+    CHECK_EQ(first.UseCount(), 2);
+
+    // held output neither pins nor replaces the arena, only its own block
+    CHECK_EQ(Status::kSuccess, engine.Input("in", CreateInput(2.0f)));
+    CHECK_EQ(Status::kSuccess, engine.Forward());
+    CHECK(arena_data == engine.GetTensorArena().Data());
+    CHECK(!engine.GetTensorArena().IsShared());
+    CHECK(first.Data() != out_node->tensor.Data());
+    CHECK_EQ(first.UseCount(), 1);
+
+    Tensor second;
+    CHECK_EQ(Status::kSuccess, engine.Extract("out", second));
+    CHECK(second.Data() == out_node->tensor.Data());
+
+    const EigenTensorMap<float, 1> first_data =
+        first.GetEigenTensor<float, 1>();
+    const EigenTensorMap<float, 1> second_data =
+        second.GetEigenTensor<float, 1>();
+    for (int i = 0; i < first_data.size(); ++i) {
+        CHECK_FLOAT_EQ(first_data(i), 0.5f);
+        CHECK_FLOAT_EQ(second_data(i), 1.0f / (1.0f + std::exp(-2.0f)));
+    }
+
+    // block nobody holds is reused
+    const void* second_buffer = second.Data();
+    second                    = Tensor();
+    CHECK_EQ(Status::kSuccess, engine.Forward());
+    CHECK(second_buffer == out_node->tensor.Data());
+
+    CHECK_EQ(Status::kSuccess, engine.Release());
+}
+
+// in -> relu -> out, an i32 constant is a second output
+static TempModel SaveIntConstantModel() {
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 2, 1, 3};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+    pnnx::Operand* idx = AddOperand(graph, "idx", shape);
+    idx->type          = 4;  // i32
+
+    const std::vector<int32_t> value{1, 2, 3, 4, 5, 6};
+
+    pnnx::Attribute attr;
+    attr.type  = 4;
+    attr.shape = shape;
+    attr.data.resize(value.size() * sizeof(int32_t));
+    std::memcpy(attr.data.data(), value.data(), attr.data.size());
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "relu", {in}, {out});
+
+    pnnx::Operator* constant =
+        AddOperator(graph, "pnnx.Attribute", "constant", {}, {idx});
+    constant->attrs["data"] = attr;
+
+    AddOperator(graph, "pnnx.Output", "output", {out, idx}, {});
+
+    return TempModel(graph, "test_engine_int_constant");
+}
+
+TEST_CASE("Test Engine int constant", "[Engine]") {
+    const TempModel model = SaveIntConstantModel();
+
+    EngineOptions options;
+    options.num_threads   = 2;
+    options.pipeline_type = PipelineType::kSequential;
+
+    EngineImpl engine;
+    REQUIRE(Status::kSuccess ==
+            engine.LoadModel(model.ParamPath(), model.BinPath(), options));
+
+    Tensor input(DataType::kFloat32, {1, 1, 3, 2}, true);
+    input.GetEigenTensor<float, 4>().setConstant(1.0f);
+
+    CHECK_EQ(Status::kSuccess, engine.Input("in", input));
+    CHECK_EQ(Status::kSuccess, engine.Forward());
+
+    Tensor idx;
+    CHECK_EQ(Status::kSuccess, engine.Extract("idx", idx));
+    CHECK(IsSameDataType<int32_t>(idx.GetDataType()));
+    REQUIRE(idx.Shape() == std::vector<int>{1, 1, 3, 2});
+
+    // NCHW [1, 2, 1, 3] -> NHWC [1, 1, 3, 2]
+    const EigenTensorMap<int32_t, 1> data = idx.GetEigenTensor<int32_t, 1>();
+    const int32_t expected[6] = {1, 4, 2, 5, 3, 6};
+    for (int i = 0; i < 6; ++i) {
+        CHECK_EQ(data(i), expected[i]);
+    }
+
+    CHECK_EQ(Status::kSuccess, engine.Release());
+}
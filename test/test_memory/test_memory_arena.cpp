@@ -0,0 +1,52 @@
+#include "common.h"
+
+#include "memory_arena.h"
+#include "tensor.h"
+
+#include <cstdint>
+
+using namespace SimpleInfer;
+
+static bool IsAligned(const void* data) {
+    return (0 == (reinterpret_cast<uintptr_t>(data) % kMemoryAlignment));
+}
+
+TEST_CASE("Test MemoryArena", "[MemoryArena]") {
+    MemoryArena arena;
+    CHECK(nullptr == arena.Data());
+    CHECK(nullptr == arena.Data(kMemoryAlignment));
+    CHECK_EQ(arena.Size(), 0);
+
+    CHECK_EQ(Status::kSuccess, arena.Reserve(1000));
+    CHECK(IsAligned(arena.Data()));
+    CHECK(IsAligned(arena.Data(kMemoryAlignment * 3)));
+    CHECK_EQ(arena.Size(), 1000);
+
+    // smaller request keep the old block
+    void* data = arena.Data();
+    CHECK_EQ(Status::kSuccess, arena.Reserve(100));
+    CHECK(data == arena.Data());
+    CHECK_EQ(arena.Size(), 1000);
+
+    // shared block is left to its users
+    Tensor tensor(DataType::kFloat32, {10});
+    CHECK_EQ(Status::kSuccess, tensor.SetData(arena.Storage()));
+    CHECK(arena.IsShared());
+    CHECK_EQ(Status::kSuccess, arena.Reserve(100));
+    CHECK(data != arena.Data());
+    CHECK(data == tensor.GetEigenTensor<float, 1>().data());
+    CHECK(!arena.IsShared());
+
+    arena.Release();
+    CHECK(nullptr == arena.Data());
+    CHECK(nullptr == arena.Data(kMemoryAlignment));
+    CHECK_EQ(arena.Size(), 0);
+}
+
+TEST_CASE("Test Tensor Allocate Aligned", "[MemoryArena]") {
+    for (int c = 1; c < 8; ++c) {
+        Tensor tensor(DataType::kFloat32, {1, 3, 5, c}, true);
+
+        CHECK(IsAligned(tensor.GetEigenTensor<float, 4>().data()));
+    }
+}
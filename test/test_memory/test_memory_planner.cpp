@@ -0,0 +1,149 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "memory_planner.h"
+
+#include <string>
+#include <vector>
+
+using namespace SimpleInfer;
+
+static bool IsOverlap(const MemoryPlanner& planner,
+                      const std::string& name0,
+                      size_t size0,
+                      const std::string& name1,
+                      size_t size1) {
+    const size_t offset0 = planner.GetOffset(name0);
+    const size_t offset1 = planner.GetOffset(name1);
+
+    return (offset0 < offset1 + size1) && (offset1 < offset0 + size0);
+}
+
+TEST_CASE("Test MemoryPlanner chain", "[MemoryPlanner]") {
+    // in -> t0 -> t1 -> t2 -> t3 -> out
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 4, 8, 8};
+    const size_t size = 4 * 8 * 8 * sizeof(float);
+
+    pnnx::Operand* in = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0 = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1 = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2 = AddOperand(graph, "t2", shape);
+    pnnx::Operand* t3 = AddOperand(graph, "t3", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "op0", {in}, {t0});
+    AddOperator(graph, "nn.ReLU", "op1", {t0}, {t1});
+    AddOperator(graph, "nn.ReLU", "op2", {t1}, {t2});
+    AddOperator(graph, "nn.ReLU", "op3", {t2}, {t3});
+    AddOperator(graph, "pnnx.Output", "output", {t3}, {});
+
+    MemoryPlanner planner;
+    CHECK_EQ(Status::kSuccess, planner.Plan(&graph));
+
+    CHECK(!planner.HasOffset("in"));
+    CHECK(planner.HasOffset("t3"));
+
+    CHECK_EQ(planner.GetNaiveSize(), 4 * size);
+    CHECK_EQ(planner.GetPeakSize(), 2 * size);
+
+    // producer and consumer alive at the same time
+    CHECK(!IsOverlap(planner, "t0", size, "t1", size));
+    CHECK(!IsOverlap(planner, "t1", size, "t2", size));
+
+    // graph output in a block of its own
+    CHECK(!planner.IsPinned("t2"));
+    REQUIRE(planner.IsPinned("t3"));
+    CHECK_EQ(planner.GetPinnedRoot("t3"), "t3");
+    CHECK_EQ(planner.GetOffset("t3"), 0);
+    CHECK_EQ(planner.GetPinnedSizes().size(), 1);
+    CHECK_EQ(planner.GetPinnedSizes().at("t3"), size);
+}
+
+TEST_CASE("Test MemoryPlanner branch", "[MemoryPlanner]") {
+    //       -> a0 -> a1 -
+    // in ->               -> cat -> out
+    //       -> b0 -> b1 -
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 4, 8, 8};
+    const size_t size = 4 * 8 * 8 * sizeof(float);
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* a0  = AddOperand(graph, "a0", shape);
+    pnnx::Operand* a1  = AddOperand(graph, "a1", shape);
+    pnnx::Operand* b0  = AddOperand(graph, "b0", shape);
+    pnnx::Operand* b1  = AddOperand(graph, "b1", shape);
+    pnnx::Operand* cat = AddOperand(graph, "cat", {1, 8, 8, 8});
+    pnnx::Operand* c0  = AddOperand(graph, "c0", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "opa0", {in}, {a0});
+    AddOperator(graph, "nn.ReLU", "opa1", {a0}, {a1});
+    AddOperator(graph, "nn.ReLU", "opb0", {in}, {b0});
+    AddOperator(graph, "nn.ReLU", "opb1", {b0}, {b1});
+    AddOperator(graph, "torch.cat", "opcat", {a1, b1}, {cat});
+    AddOperator(graph, "nn.Conv2d", "opc0", {cat}, {c0});
+    AddOperator(graph, "pnnx.Output", "output", {c0}, {});
+
+    MemoryPlanner planner;
+    CHECK_EQ(Status::kSuccess, planner.Plan(&graph));
+
+    // branches may run concurrently, never share memory between them
+    CHECK(!IsOverlap(planner, "a0", size, "b0", size));
+    CHECK(!IsOverlap(planner, "a0", size, "b1", size));
+    CHECK(!IsOverlap(planner, "a1", size, "b0", size));
+    CHECK(!IsOverlap(planner, "a1", size, "b1", size));
+
+    // cat output may reuse memory of the dead branch heads only
+    CHECK(!IsOverlap(planner, "cat", 2 * size, "a1", size));
+    CHECK(!IsOverlap(planner, "cat", 2 * size, "b1", size));
+
+    CHECK_LT(planner.GetPeakSize(), planner.GetNaiveSize());
+}
+
+TEST_CASE("Test MemoryPlanner alias", "[MemoryPlanner]") {
+    // in -> t0 -> t1 (in place) -> t2 -> out
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 4, 8, 8};
+    const size_t size = 4 * 8 * 8 * sizeof(float);
+
+    pnnx::Operand* in = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0 = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1 = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2 = AddOperand(graph, "t2", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.Conv2d", "op0", {in}, {t0});
+    AddOperator(graph, "nn.SiLU", "op1", {t0}, {t1});
+    AddOperator(graph, "nn.Conv2d", "op2", {t1}, {t2});
+    AddOperator(graph, "pnnx.Output", "output", {t2}, {});
+
+    MemoryPlanner planner;
+    planner.SetAlias("t1", "t0");
+    CHECK_EQ(Status::kSuccess, planner.Plan(&graph));
+
+    CHECK_EQ(planner.GetOffset("t0"), planner.GetOffset("t1"));
+    CHECK(planner.IsPinned("t2"));
+    CHECK_EQ(planner.GetPeakSize(), size);
+
+    // an output aliased into another operand pins the root
+    MemoryPlanner planner_output;
+    planner_output.SetAlias("t1", "t0");
+    planner_output.SetAlias("t2", "t1", size);
+    planner_output.SetSize("t1", 2 * size);
+    CHECK_EQ(Status::kSuccess, planner_output.Plan(&graph));
+
+    REQUIRE(planner_output.IsPinned("t0"));
+    CHECK_EQ(planner_output.GetPinnedRoot("t2"), "t0");
+    CHECK_EQ(planner_output.GetOffset("t2"), size);
+    CHECK_EQ(planner_output.GetPinnedSizes().at("t0"), 2 * size);
+    CHECK_EQ(planner_output.GetPeakSize(), 0);
+
+    // alias to input memory is not allowed
+    MemoryPlanner planner_fail;
+    planner_fail.SetAlias("t0", "in");
+    CHECK_EQ(Status::kFail, planner_fail.Plan(&graph));
+}
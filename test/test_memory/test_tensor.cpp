@@ -0,0 +1,109 @@
+#include "common.h"
+
+#include "layer.h"
+#include "memory_arena.h"
+#include "tensor.h"
+
+#include <utility>
+
+using namespace SimpleInfer;
+
+TEST_CASE("Test Tensor share", "[Tensor]") {
+    Tensor tensor(DataType::kFloat32, {2, 3}, true);
+    CHECK_EQ(tensor.UseCount(), 1);
+
+    // copy is a view of the same storage
+    Tensor view = tensor;
+    CHECK_EQ(tensor.UseCount(), 2);
+    CHECK(tensor.GetEigenTensor<float, 2>().data() ==
+          view.GetEigenTensor<float, 2>().data());
+
+    // storage outlives the tensor which allocated it
+    float* data = tensor.GetEigenTensor<float, 2>().data();
+    tensor      = Tensor();
+    CHECK_EQ(view.UseCount(), 1);
+    CHECK(data == view.GetEigenTensor<float, 2>().data());
+
+    // move steals the storage
+    Tensor moved = std::move(view);
+    CHECK_EQ(moved.UseCount(), 1);
+    CHECK_EQ(view.UseCount(), 0);
+    CHECK(view.Shape().empty());
+    CHECK(data == moved.GetEigenTensor<float, 2>().data());
+
+    // external memory is not owned
+    float external[6];
+    CHECK_EQ(Status::kSuccess, moved.SetData(external));
+    CHECK_EQ(moved.UseCount(), 0);
+}
+
+TEST_CASE("Test Tensor SetData offset", "[Tensor]") {
+    MemoryArena arena;
+    CHECK_EQ(Status::kSuccess, arena.Reserve(1024));
+
+    Tensor tensor(DataType::kFloat32, {4, 4});
+    CHECK_EQ(Status::kSuccess, tensor.SetData(arena.Storage(), 256));
+    CHECK(arena.Data(256) == tensor.GetEigenTensor<float, 2>().data());
+    CHECK_EQ(tensor.UseCount(), 2);
+
+    // shared storage is not touched by Allocate
+    CHECK_EQ(Status::kSuccess, tensor.Allocate(DataType::kFloat32, {4, 4}));
+    CHECK(arena.Data(256) == tensor.GetEigenTensor<float, 2>().data());
+}
+
+TEST_CASE("Test Tensor Reshape", "[Tensor]") {
+    Tensor tensor(DataType::kFloat32, {2, 3, 4}, true);
+    float* data = tensor.GetEigenTensor<float, 3>().data();
+
+    Tensor view = tensor;
+    CHECK_EQ(Status::kSuccess, view.Reshape({6, 4}));
+    CHECK(view.Shape() == std::vector<int>{6, 4});
+    CHECK(tensor.Shape() == std::vector<int>{2, 3, 4});
+    CHECK(data == view.GetEigenTensor<float, 2>().data());
+
+    CHECK_EQ(Status::kErrorShape, view.Reshape({5, 4}));
+}
+
+TEST_CASE("Test Tensor layout", "[Tensor]") {
+    const std::vector<int> shape{2, 3, 2, 7};
+
+    Tensor tensor(DataType::kFloat32, shape, true);
+    EigenTensorMap<float, 1> data = tensor.GetEigenTensor<float, 1>();
+    for (int i = 0; i < data.size(); ++i) {
+        data(i) = (float)i;
+    }
+
+    // [n * 2, h, w, 4], last block has one padded channel
+    Tensor nc4hw4(DataType::kFloat32,
+                  LayoutShape(shape, Layout::kNC4HW4),
+                  true);
+    nc4hw4.SetLayout(Layout::kNC4HW4);
+    CHECK(nc4hw4.Shape() == std::vector<int>{4, 3, 2, 4});
+    CHECK_EQ(Status::kSuccess, ReorderLayout(nullptr, tensor, nc4hw4, 7));
+
+    // copies keep the layout
+    Tensor view = nc4hw4;
+    CHECK(Layout::kNC4HW4 == view.GetLayout());
+
+    const EigenTensorMap<float, 4> blocked = nc4hw4.GetEigenTensor<float, 4>();
+    const EigenTensorMap<float, 4> nhwc    = tensor.GetEigenTensor<float, 4>();
+    CHECK_EQ(blocked(1 * 2 + 1, 2, 1, 1), nhwc(1, 2, 1, 5));
+    CHECK_EQ(blocked(0 * 2 + 0, 1, 0, 3), nhwc(0, 1, 0, 3));
+    CHECK_EQ(blocked(1 * 2 + 1, 0, 1, 3), 0.0f);
+
+    // through another blocked layout back to NHWC
+    Tensor nc8hw8(DataType::kFloat32,
+                  LayoutShape(shape, Layout::kNC8HW8),
+                  true);
+    nc8hw8.SetLayout(Layout::kNC8HW8);
+    CHECK_EQ(Status::kSuccess, ReorderLayout(nullptr, nc4hw4, nc8hw8, 7));
+
+    Tensor result(DataType::kFloat32, shape, true);
+    CHECK_EQ(Status::kSuccess, ReorderLayout(nullptr, nc8hw8, result, 7));
+
+    const EigenTensorMap<float, 1> result_data =
+        result.GetEigenTensor<float, 1>();
+    for (int i = 0; i < data.size(); ++i) {
+        CHECK_EQ(result_data(i), data(i));
+    }
+}
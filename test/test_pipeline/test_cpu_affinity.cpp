@@ -0,0 +1,139 @@
+#include "common.h"
+
+#include "context.h"
+#include "cpu_affinity.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+using namespace SimpleInfer;
+
+TEST_CASE("Test ParseCpuList", "[CpuAffinity]") {
+    std::vector<int> cpu_ids;
+
+    CHECK_EQ(Status::kSuccess, ParseCpuList("0-3,8,10-11", cpu_ids));
+    CHECK(cpu_ids == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+
+    CHECK_EQ(Status::kSuccess, ParseCpuList("5", cpu_ids));
+    CHECK(cpu_ids == std::vector<int>{5});
+
+    // sysfs line of a node without cpus
+    CHECK_EQ(Status::kSuccess, ParseCpuList("", cpu_ids));
+    CHECK(cpu_ids.empty());
+
+    CHECK_EQ(Status::kSuccess, ParseCpuList("2-3 ", cpu_ids));
+    CHECK(cpu_ids == std::vector<int>{2, 3});
+
+    for (const std::string& cpu_list :
+         {"a", "1-", "-1", "3-1", "1-2x", "0,,x"}) {
+        cpu_ids = {7};
+        CHECK_EQ(Status::kFail, ParseCpuList(cpu_list, cpu_ids));
+        CHECK(cpu_ids.empty());
+    }
+}
+
+#if defined(__linux__)
+
+TEST_CASE("Test GetNumaNodeCpus", "[CpuAffinity]") {
+    std::vector<int> cpu_ids;
+
+    if (std::filesystem::exists("/sys/devices/system/node/node0/cpulist")) {
+        CHECK_EQ(Status::kSuccess, GetNumaNodeCpus(0, cpu_ids));
+        CHECK_FALSE(cpu_ids.empty());
+    }
+
+    CHECK(Status::kSuccess != GetNumaNodeCpus(1 << 20, cpu_ids));
+    CHECK(cpu_ids.empty());
+}
+
+// cpus of the calling thread
+static std::vector<int> GetThreadCpus() {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    sched_getaffinity(0, sizeof(cpu_set), &cpu_set);
+
+    std::vector<int> cpu_ids;
+    for (int cpu_id = 0; cpu_id < CPU_SETSIZE; ++cpu_id) {
+        if (CPU_ISSET(cpu_id, &cpu_set)) {
+            cpu_ids.push_back(cpu_id);
+        }
+    }
+
+    return cpu_ids;
+}
+
+TEST_CASE("Test SetThreadAffinity", "[CpuAffinity]") {
+    // only cpus this process may run on
+    const std::vector<int> allowed_cpu_ids = GetThreadCpus();
+    REQUIRE_FALSE(allowed_cpu_ids.empty());
+
+    const int cpu_id = allowed_cpu_ids.back();
+
+    std::vector<int> pinned_cpu_ids;
+    std::thread thread([&]() {
+        CHECK_EQ(Status::kSuccess, SetThreadAffinity(cpu_id));
+        pinned_cpu_ids = GetThreadCpus();
+    });
+    thread.join();
+
+    CHECK(pinned_cpu_ids == std::vector<int>{cpu_id});
+
+    CHECK(Status::kSuccess != SetThreadAffinity(-1));
+    CHECK(Status::kSuccess != SetThreadAffinity(CPU_SETSIZE));
+}
+
+TEST_CASE("Test context pool pinned to cpu_ids", "[CpuAffinity]") {
+    const std::vector<int> allowed_cpu_ids = GetThreadCpus();
+    REQUIRE_FALSE(allowed_cpu_ids.empty());
+
+    // thread i on cpu_ids[i % size]
+    std::vector<int> cpu_ids{allowed_cpu_ids.front()};
+    if (allowed_cpu_ids.size() > 1) {
+        cpu_ids.push_back(allowed_cpu_ids.back());
+    }
+
+    const int num_threads = 4;
+
+    Context context;
+    context.InitEigenThreadPoolDevice(num_threads, cpu_ids);
+    CHECK(context.GetCpuIds() == cpu_ids);
+
+    Eigen::ThreadPoolInterface* pool = context.GetThreadPool();
+    REQUIRE(nullptr != pool);
+
+    // every pool thread reports its cpus once
+    std::vector<std::vector<int>> thread_cpu_ids(num_threads);
+
+    Eigen::Barrier barrier(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        pool->Schedule([&]() {
+            const int thread = pool->CurrentThreadId();
+            if (thread >= 0 && thread < num_threads) {
+                thread_cpu_ids[thread] = GetThreadCpus();
+            }
+
+            barrier.Notify();
+        });
+    }
+    barrier.Wait();
+
+    for (const std::vector<int>& thread_cpus : thread_cpu_ids) {
+        if (thread_cpus.empty()) {
+            // another thread took its task
+            continue;
+        }
+
+        REQUIRE(1 == thread_cpus.size());
+        CHECK(std::find(cpu_ids.begin(), cpu_ids.end(), thread_cpus[0]) !=
+              cpu_ids.end());
+    }
+}
+
+#endif
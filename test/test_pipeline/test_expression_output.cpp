@@ -0,0 +1,74 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "engine_impl.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace SimpleInfer;
+
+// graph output produced by an expression
+// in -> relu -> t0
+// (in + t0) * in -> out
+static TempModel SaveExpressionModel() {
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 4, 4};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0  = AddOperand(graph, "t0", shape);
+    pnnx::Operand* out = AddOperand(graph, "out", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "relu", {in}, {t0});
+
+    pnnx::Operator* expr =
+        AddOperator(graph, "pnnx.Expression", "expr", {in, t0}, {out});
+    expr->params["expr"] = pnnx::Parameter("mul(add(@0,@1),@0)");
+
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    return TempModel(graph, "test_expression_output");
+}
+
+TEST_CASE("Test Engine expression output", "[Engine]") {
+    const TempModel model = SaveExpressionModel();
+
+    Tensor input(DataType::kFloat32, {1, 4, 4, 8}, true);
+
+    EigenTensorMap<float, 1> input_data = input.GetEigenTensor<float, 1>();
+    for (int i = 0; i < input_data.size(); ++i) {
+        input_data(i) = (float)(i % 13) * 0.5f - 3.0f;
+    }
+
+    // default options run the graph as exported
+    for (const bool optimize_graph : {false, true}) {
+        EngineOptions options;
+        options.optimize_graph = optimize_graph;
+
+        EngineImpl engine;
+        REQUIRE(Status::kSuccess ==
+                engine.LoadModel(model.ParamPath(), model.BinPath(), options));
+
+        // output keeps its name when the expression is expanded
+        CHECK(engine.OutputNames() == std::vector<std::string>{"out"});
+
+        CHECK_EQ(Status::kSuccess, engine.Input("in", input));
+        CHECK_EQ(Status::kSuccess, engine.Forward());
+
+        Tensor output;
+        REQUIRE(Status::kSuccess == engine.Extract("out", output));
+        REQUIRE(input.Shape() == output.Shape());
+
+        const EigenTensorMap<float, 1> output_data =
+            output.GetEigenTensor<float, 1>();
+        for (int i = 0; i < input_data.size(); ++i) {
+            const float x = input_data(i);
+            CHECK_FLOAT_EQ(output_data(i), (x + (std::max)(x, 0.0f)) * x);
+        }
+
+        CHECK_EQ(Status::kSuccess, engine.Release());
+    }
+}
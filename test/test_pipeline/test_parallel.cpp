@@ -0,0 +1,67 @@
+#include "common.h"
+
+#include "context.h"
+#include "layer/simd/parallel.h"
+
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace SimpleInfer;
+
+TEST_CASE("Test Parallel runs on the context pool", "[Parallel]") {
+    const int num_threads = 4;
+
+    Context context;
+    context.InitEigenThreadPoolDevice(num_threads);
+
+    Eigen::ThreadPoolDevice* device   = context.GetEigenThreadPoolDevice();
+    Eigen::ThreadPoolInterface* pool = context.GetThreadPool();
+    REQUIRE(nullptr != device);
+    REQUIRE(nullptr != pool);
+
+    const std::thread::id caller_id = std::this_thread::get_id();
+
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+    std::set<size_t> thread_indices;
+    int num_foreign_blocks = 0;
+
+    const size_t size = 1024;
+    std::vector<int> data(size, 0);
+
+    const int num_runs = 64;
+    for (int run = 0; run < num_runs; ++run) {
+        Parallel(device, 0, size, [&](size_t thread, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                ++data[i];
+            }
+
+            const std::thread::id id = std::this_thread::get_id();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            thread_ids.insert(id);
+            thread_indices.insert(thread);
+
+            // neither the caller nor a thread of the pool
+            if (caller_id != id && pool->CurrentThreadId() < 0) {
+                ++num_foreign_blocks;
+            }
+        });
+    }
+
+    CHECK_EQ(num_foreign_blocks, 0);
+
+    // the first block is the caller's own
+    CHECK(thread_ids.count(caller_id) > 0);
+
+    // a fixed set of threads across runs, nothing spawned per call
+    CHECK(thread_ids.size() <= (size_t)num_threads + 1);
+
+    CHECK(*thread_indices.rbegin() < (size_t)device->numThreads());
+
+    for (size_t i = 0; i < size; ++i) {
+        CHECK_EQ(data[i], num_runs);
+    }
+}
@@ -0,0 +1,132 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "engine_impl.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace SimpleInfer;
+
+// two outputs of separate branches
+// in -> relu -> silu -> out0
+// in -> sigmoid -> hardswish -> out1
+static TempModel SaveTwoOutputModel() {
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 4, 4};
+
+    pnnx::Operand* in   = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0   = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1   = AddOperand(graph, "t1", shape);
+    pnnx::Operand* out0 = AddOperand(graph, "out0", shape);
+    pnnx::Operand* out1 = AddOperand(graph, "out1", shape);
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "relu", {in}, {t0});
+    AddOperator(graph, "nn.SiLU", "silu", {t0}, {out0});
+    AddOperator(graph, "nn.Sigmoid", "sigmoid", {in}, {t1});
+    AddOperator(graph, "nn.Hardswish", "hardswish", {t1}, {out1});
+    AddOperator(graph, "pnnx.Output", "output", {out0, out1}, {});
+
+    return TempModel(graph, "test_partial_forward");
+}
+
+static Tensor CreateInput() {
+    Tensor input(DataType::kFloat32, {1, 4, 4, 8}, true);
+
+    EigenTensorMap<float, 1> data = input.GetEigenTensor<float, 1>();
+    for (int i = 0; i < data.size(); ++i) {
+        data(i) = (float)(i % 17) * 0.5f - 4.0f;
+    }
+
+    return input;
+}
+
+static std::set<std::string> GetLayerNames(const Profiler* profiler) {
+    std::set<std::string> names;
+    for (const ProfileEvent& event : profiler->GetEvents()) {
+        names.insert(event.name);
+    }
+
+    return names;
+}
+
+static void CheckSameTensor(const Tensor& expected, const Tensor& output) {
+    REQUIRE(expected.Shape() == output.Shape());
+
+    const EigenTensorMap<float, 1> expected_data =
+        expected.GetEigenTensor<float, 1>();
+    const EigenTensorMap<float, 1> output_data =
+        output.GetEigenTensor<float, 1>();
+    for (int i = 0; i < expected_data.size(); ++i) {
+        CHECK_FLOAT_EQ(expected_data(i), output_data(i));
+    }
+}
+
+TEST_CASE("Test Engine partial forward", "[Engine]") {
+    const TempModel model = SaveTwoOutputModel();
+
+    for (const PipelineType pipeline_type : {PipelineType::kStatic,
+                                             PipelineType::kSequential,
+                                             PipelineType::kCostModel}) {
+        EngineOptions options;
+        options.num_threads    = 2;
+        options.pipeline_type  = pipeline_type;
+        options.optimize_graph = false;
+        options.enable_profile = true;
+
+        EngineImpl engine;
+        REQUIRE(Status::kSuccess ==
+                engine.LoadModel(model.ParamPath(), model.BinPath(), options));
+
+        CHECK_EQ(Status::kSuccess, engine.Input("in", CreateInput()));
+        CHECK_EQ(Status::kSuccess, engine.Forward());
+
+        Tensor expected0;
+        Tensor expected1;
+        CHECK_EQ(Status::kSuccess, engine.Extract("out0", expected0));
+        CHECK_EQ(Status::kSuccess, engine.Extract("out1", expected1));
+
+        const Profiler* profiler = engine.GetProfiler();
+        REQUIRE(nullptr != profiler);
+
+        // only the producers of out1
+        CHECK_EQ(Status::kSuccess, engine.ClearProfile());
+        CHECK_EQ(Status::kSuccess, engine.Forward({"out1"}));
+        CHECK(GetLayerNames(profiler) ==
+              std::set<std::string>{"sigmoid", "hardswish"});
+
+        Tensor output1;
+        CHECK_EQ(Status::kSuccess, engine.Extract("out1", output1));
+        CheckSameTensor(expected1, output1);
+
+        // cached plan of out0
+        for (int i = 0; i < 2; ++i) {
+            CHECK_EQ(Status::kSuccess, engine.ClearProfile());
+            CHECK_EQ(Status::kSuccess, engine.Forward({"out0"}));
+            CHECK(GetLayerNames(profiler) ==
+                  std::set<std::string>{"relu", "silu"});
+
+            Tensor output0;
+            CHECK_EQ(Status::kSuccess, engine.Extract("out0", output0));
+            CheckSameTensor(expected0, output0);
+        }
+
+        // both outputs need the whole graph
+        CHECK_EQ(Status::kSuccess, engine.ClearProfile());
+        CHECK_EQ(Status::kSuccess, engine.Forward({"out0", "out1"}));
+        CHECK_EQ(GetLayerNames(profiler).size(), 4);
+
+        Tensor output0;
+        CHECK_EQ(Status::kSuccess, engine.Extract("out0", output0));
+        CheckSameTensor(expected0, output0);
+        CHECK_EQ(Status::kSuccess, engine.Extract("out1", output1));
+        CheckSameTensor(expected1, output1);
+
+        CHECK(Status::kSuccess != engine.Forward({"t0"}));
+
+        CHECK_EQ(Status::kSuccess, engine.Release());
+    }
+}
@@ -0,0 +1,172 @@
+#include "common.h"
+#include "graph_builder.h"
+
+#include "engine_impl.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace SimpleInfer;
+
+// two branches joined by a channel concat
+// in -> relu -> silu ----------> cat -> hardswish -> out
+// in -> sigmoid -> hardsigmoid -^
+static TempModel SaveBranchModel() {
+    pnnx::Graph graph;
+
+    const std::vector<int> shape{1, 8, 8, 8};
+
+    pnnx::Operand* in  = AddOperand(graph, "in", shape);
+    pnnx::Operand* t0  = AddOperand(graph, "t0", shape);
+    pnnx::Operand* t1  = AddOperand(graph, "t1", shape);
+    pnnx::Operand* t2  = AddOperand(graph, "t2", shape);
+    pnnx::Operand* t3  = AddOperand(graph, "t3", shape);
+    pnnx::Operand* t4  = AddOperand(graph, "t4", {1, 16, 8, 8});
+    pnnx::Operand* out = AddOperand(graph, "out", {1, 16, 8, 8});
+
+    AddOperator(graph, "pnnx.Input", "input", {}, {in});
+    AddOperator(graph, "nn.ReLU", "relu", {in}, {t0});
+    AddOperator(graph, "nn.Sigmoid", "sigmoid", {in}, {t1});
+    AddOperator(graph, "nn.SiLU", "silu", {t0}, {t2});
+    AddOperator(graph, "nn.Hardsigmoid", "hardsigmoid", {t1}, {t3});
+
+    pnnx::Operator* cat =
+        AddOperator(graph, "torch.cat", "cat", {t2, t3}, {t4});
+    cat->params["dim"] = pnnx::Parameter(1);
+
+    AddOperator(graph, "nn.Hardswish", "hardswish", {t4}, {out});
+    AddOperator(graph, "pnnx.Output", "output", {out}, {});
+
+    return TempModel(graph, "test_scheduler");
+}
+
+static Tensor CreateRandomInput() {
+    Tensor input(DataType::kFloat32, {1, 8, 8, 8}, true);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+
+    EigenTensorMap<float, 1> data = input.GetEigenTensor<float, 1>();
+    for (int i = 0; i < data.size(); ++i) {
+        data(i) = distribution(generator);
+    }
+
+    return input;
+}
+
+static EngineOptions CreateOptions(const PipelineType pipeline_type) {
+    EngineOptions options;
+    options.num_threads    = 4;
+    options.pipeline_type  = pipeline_type;
+    options.optimize_graph = false;
+
+    return options;
+}
+
+static void RunBranchModel(const TempModel& model,
+                           const EngineOptions& options,
+                           const int num_runs,
+                           Tensor& output) {
+    EngineImpl engine;
+    REQUIRE(Status::kSuccess ==
+            engine.LoadModel(model.ParamPath(), model.BinPath(), options));
+
+    CHECK_EQ(Status::kSuccess, engine.Input("in", CreateRandomInput()));
+    for (int i = 0; i < num_runs; ++i) {
+        CHECK_EQ(Status::kSuccess, engine.Forward());
+    }
+
+    CHECK_EQ(Status::kSuccess, engine.Extract("out", output));
+    CHECK_EQ(Status::kSuccess, engine.Release());
+}
+
+TEST_CASE("Test Scheduler dependency order", "[Scheduler]") {
+    const TempModel model = SaveBranchModel();
+
+    EngineOptions options  = CreateOptions(PipelineType::kCostModel);
+    options.enable_profile = true;
+
+    EngineImpl engine;
+    REQUIRE(Status::kSuccess ==
+            engine.LoadModel(model.ParamPath(), model.BinPath(), options));
+
+    const int num_runs = 8;
+
+    CHECK_EQ(Status::kSuccess, engine.Input("in", CreateRandomInput()));
+    for (int i = 0; i < num_runs; ++i) {
+        CHECK_EQ(Status::kSuccess, engine.Forward());
+    }
+
+    const Profiler* profiler = engine.GetProfiler();
+    REQUIRE(nullptr != profiler);
+
+    // (run, layer) -> event
+    std::map<std::pair<int, std::string>, const ProfileEvent*> events;
+    for (const ProfileEvent& event : profiler->GetEvents()) {
+        events[std::make_pair(event.run, event.name)] = &event;
+    }
+
+    const std::vector<std::pair<std::string, std::string>> edges{
+        {"relu", "silu"},
+        {"sigmoid", "hardsigmoid"},
+        {"silu", "cat"},
+        {"hardsigmoid", "cat"},
+        {"cat", "hardswish"},
+    };
+
+    std::map<int, int> layers_of_run;
+    for (const auto& event_iter : events) {
+        ++layers_of_run[event_iter.first.first];
+    }
+    CHECK_EQ((int)layers_of_run.size(), num_runs);
+
+    for (const auto& run_iter : layers_of_run) {
+        const int run = run_iter.first;
+
+        // every layer once per run
+        CHECK_EQ(run_iter.second, 6);
+
+        for (const auto& edge : edges) {
+            auto producer = events.find(std::make_pair(run, edge.first));
+            auto consumer = events.find(std::make_pair(run, edge.second));
+            REQUIRE(events.end() != producer);
+            REQUIRE(events.end() != consumer);
+
+            CHECK(producer->second->end <= consumer->second->start);
+        }
+    }
+
+    CHECK_EQ(Status::kSuccess, engine.Release());
+}
+
+TEST_CASE("Test Scheduler equals sequential", "[Scheduler]") {
+    const TempModel model = SaveBranchModel();
+
+    Tensor expected;
+    RunBranchModel(model,
+                   CreateOptions(PipelineType::kSequential),
+                   1,
+                   expected);
+
+    // with and without a limit on concurrent branches
+    for (const int num_pipeline_threads : {0, 1, 2}) {
+        EngineOptions options = CreateOptions(PipelineType::kCostModel);
+        options.num_pipeline_threads = num_pipeline_threads;
+
+        Tensor output;
+        RunBranchModel(model, options, 4, output);
+
+        REQUIRE(expected.Shape() == output.Shape());
+
+        const EigenTensorMap<float, 1> expected_data =
+            expected.GetEigenTensor<float, 1>();
+        const EigenTensorMap<float, 1> output_data =
+            output.GetEigenTensor<float, 1>();
+        for (int i = 0; i < expected_data.size(); ++i) {
+            CHECK_FLOAT_EQ(expected_data(i), output_data(i));
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include "common.h"
+
+#include "layer/relu.h"
+#include "profiler.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace SimpleInfer;
+
+TEST_CASE("Test Profiler", "[Profiler]") {
+    const std::vector<int> shape{1, 8, 8, 4};
+
+    pnnx::Graph graph;
+    pnnx::Operator* op = graph.new_operator("nn.ReLU", "relu_0");
+
+    TensorNode input_node;
+    input_node.tensor = Tensor(DataType::kFloat32, shape, true);
+    input_node.tensor.GetEigenTensor<float, 4>().setRandom();
+
+    TensorNode output_node;
+    output_node.tensor = Tensor(DataType::kFloat32, shape, true);
+
+    ReLU relu_layer;
+    CHECK_EQ(Status::kSuccess, relu_layer.Init(op));
+    relu_layer.SetInputNodes({&input_node});
+    relu_layer.SetOutputNodes({&output_node});
+
+    Profiler profiler;
+    for (int i = 0; i < 3; ++i) {
+        profiler.BeginRun();
+        CHECK_EQ(Status::kSuccess, profiler.Forward(&relu_layer));
+    }
+
+    const std::vector<ProfileEvent>& events = profiler.GetEvents();
+    REQUIRE(events.size() == 3);
+    for (int i = 0; i < 3; ++i) {
+        CHECK_EQ(events[i].name, "relu_0");
+        CHECK_EQ(events[i].type, "nn.ReLU");
+        CHECK_EQ(events[i].run, i + 1);
+        CHECK(events[i].start <= events[i].end);
+        CHECK(events[i].output_shapes[0] == shape);
+        CHECK_EQ(events[i].flops, 8 * 8 * 4);
+    }
+
+    const std::string summary = profiler.Summary();
+    CHECK(std::string::npos != summary.find("relu_0"));
+    CHECK(std::string::npos != summary.find("in 3 runs"));
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "test_profiler_trace.json")
+            .string();
+    CHECK_EQ(Status::kSuccess, profiler.SaveChromeTrace(path));
+
+    {
+        std::ifstream file(path);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        CHECK_EQ(ss.str().find("{\"traceEvents\":["), 0);
+        CHECK(std::string::npos != ss.str().find("\"name\":\"relu_0\""));
+    }
+
+    std::remove(path.c_str());
+
+    profiler.Clear();
+    CHECK(profiler.GetEvents().empty());
+}
+
+TEST_CASE("Test Profiler max events", "[Profiler]") {
+    const std::vector<int> shape{1, 2, 2, 4};
+
+    pnnx::Graph graph;
+    pnnx::Operator* op = graph.new_operator("nn.ReLU", "relu_0");
+
+    TensorNode input_node;
+    input_node.tensor = Tensor(DataType::kFloat32, shape, true);
+    input_node.tensor.GetEigenTensor<float, 4>().setRandom();
+
+    TensorNode output_node;
+    output_node.tensor = Tensor(DataType::kFloat32, shape, true);
+
+    ReLU relu_layer;
+    CHECK_EQ(Status::kSuccess, relu_layer.Init(op));
+    relu_layer.SetInputNodes({&input_node});
+    relu_layer.SetOutputNodes({&output_node});
+
+    // layers still run once the events are full
+    Profiler profiler(2);
+    for (int i = 0; i < 5; ++i) {
+        profiler.BeginRun();
+        CHECK_EQ(Status::kSuccess, profiler.Forward(&relu_layer));
+    }
+
+    CHECK_EQ(profiler.GetEvents().size(), 2);
+    CHECK_EQ(profiler.GetDroppedCount(), 3);
+    CHECK(std::string::npos != profiler.Summary().find("3 events dropped"));
+
+    profiler.Clear();
+    CHECK(profiler.GetEvents().empty());
+    CHECK_EQ(profiler.GetDroppedCount(), 0);
+}
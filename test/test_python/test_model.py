@@ -39,3 +39,14 @@ if __name__ == '__main__':
     print(output_np.dtype, output_np.shape)
 
     print(output_np[0, 0, 0, :])
+
+    # only the layers the first output needs
+    rc = engine.Forward([output_names[0]])
+    print('Forward', output_names[0], rc)
+
+    partial_tensor = infer.Tensor()
+    rc = engine.Extract(output_names[0], partial_tensor)
+    print('Extract', rc)
+
+    partial_np = partial_tensor.GetTensorDim4()
+    print('same output', np.allclose(output_np, partial_np))
@@ -101,6 +101,34 @@ target("test-gemm")
     add_files("test/test_3rdparty/test_gemm.cpp")
     add_deps("simple-infer", "catch2")
 
+target("test-memory")
+    set_kind("binary")
+    add_includedirs("src/", "test/")
+    add_files("test/test_main.cpp")
+    add_files("test/test_memory/**.cpp")
+    add_deps("simple-infer", "catch2")
+
+target("test-graph")
+    set_kind("binary")
+    add_includedirs("src/", "test/")
+    add_files("test/test_main.cpp")
+    add_files("test/test_graph/**.cpp")
+    add_deps("simple-infer", "catch2")
+
+target("test-profiler")
+    set_kind("binary")
+    add_includedirs("src/", "test/")
+    add_files("test/test_main.cpp")
+    add_files("test/test_profiler/**.cpp")
+    add_deps("simple-infer", "catch2")
+
+target("test-pipeline")
+    set_kind("binary")
+    add_includedirs("src/", "test/")
+    add_files("test/test_main.cpp")
+    add_files("test/test_pipeline/**.cpp")
+    add_deps("simple-infer", "catch2")
+
 target("test-yolo")
     set_kind("binary")
     add_includedirs("src/")